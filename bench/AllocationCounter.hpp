@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+namespace argparser::bench {
+
+// Number of global operator new calls since program start.
+[[nodiscard]] std::size_t allocationCount() noexcept;
+
+class AllocationScope {
+public:
+    AllocationScope() noexcept : m_start(allocationCount()) {}
+
+    [[nodiscard]] std::size_t count() const noexcept { return allocationCount() - m_start; }
+
+private:
+    std::size_t m_start;
+};
+
+}
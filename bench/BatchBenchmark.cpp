@@ -0,0 +1,109 @@
+#include "AllocationCounter.hpp"
+#include "BenchSupport.hpp"
+
+#include "ArgParser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using argparser::ArgParser;
+using argparser::BatchResult;
+using argparser::CommandLine;
+using argparser::Executor;
+using argparser::InlineExecutor;
+using argparser::ParseResult;
+using argparser::ThreadPoolExecutor;
+using argparser::bench::AllocationScope;
+using argparser::bench::GeneratedArgv;
+using argparser::bench::buildSchema;
+using argparser::bench::reportAllocations;
+
+// Every row replays the same generated command line of 20 tokens.
+struct Batch {
+    Batch(std::size_t optionCount, std::size_t rows) : argv(optionCount, 20) {
+
+        for (auto it = argv.tokens().begin() + 1; it != argv.tokens().end(); ++it) {
+            tokens.emplace_back(*it);
+        }
+
+        lines.assign(rows, CommandLine{tokens});
+    }
+
+    GeneratedArgv argv;
+    std::vector<std::string_view> tokens;
+    std::vector<CommandLine> lines;
+};
+
+// Baseline: one ParseResult reused for every row, then read back by name.
+void BM_ReplayOneByOne(benchmark::State& state) {
+    Batch batch(100, static_cast<std::size_t>(state.range(0)));
+    ArgParser parser("generated");
+    buildSchema(parser, 100);
+    parser.freeze();
+
+    ParseResult result;
+    std::size_t given = 0;
+
+    for (auto _ : state) {
+
+        for (const auto& line : batch.lines) {
+            argparser::RangeTokenSource source(line.arguments.begin(), line.arguments.end());
+            (void)parser.tryParse(source, result);
+            given += result.count("option-0");
+        }
+    }
+
+    benchmark::DoNotOptimize(given);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch.lines.size()));
+}
+
+// threads == 0 runs the batch on the calling thread only.
+void BM_ParseBatch(benchmark::State& state) {
+    Batch batch(100, static_cast<std::size_t>(state.range(0)));
+    ArgParser parser("generated");
+    buildSchema(parser, 100);
+    parser.freeze();
+
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    std::unique_ptr<Executor> executor;
+
+    if (threads == 0) {
+        executor = std::make_unique<InlineExecutor>();
+    } else {
+        executor = std::make_unique<ThreadPoolExecutor>(threads);
+    }
+
+    BatchResult result;
+    parser.parseBatch(batch.lines, *executor, result);
+    std::size_t allocations = 0;
+    std::size_t given = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        parser.parseBatch(batch.lines, *executor, result);
+        allocations += scope.count();
+
+        for (const auto count : result.counts(result.column("option-0"))) {
+            given += count;
+        }
+    }
+
+    benchmark::DoNotOptimize(given);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch.lines.size()));
+    reportAllocations(state, allocations, "allocs/batch");
+}
+
+}
+
+BENCHMARK(BM_ReplayOneByOne)->ArgName("rows")->Arg(1000)->Arg(100000)->UseRealTime();
+
+BENCHMARK(BM_ParseBatch)
+    ->ArgNames({"rows", "threads"})
+    ->ArgsProduct({{1000, 100000}, {0, 1, 2, 4}})
+    ->UseRealTime();
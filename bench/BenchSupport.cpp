@@ -0,0 +1,124 @@
+#include "BenchSupport.hpp"
+
+#include <string>
+
+namespace argparser::bench {
+
+bool isFlagIndex(std::size_t index) noexcept {
+
+    return index % 4 == 1;
+}
+
+std::string argumentName(std::size_t index) {
+
+    return (isFlagIndex(index) ? "flag-" : "option-") + std::to_string(index);
+}
+
+void buildSchema(ArgParser& parser, std::size_t optionCount, bool withValidators) {
+
+    for (std::size_t i = 0; i < optionCount; ++i) {
+        const auto name = argumentName(i);
+
+        if (isFlagIndex(i)) {
+            parser.addFlag("", name, "Generated flag");
+            continue;
+        }
+
+        auto& arg = parser.addOption("", name, "Generated option", "0");
+
+        if (withValidators) {
+            arg.validator([](const std::string& value) {
+
+                try {
+                    const int number = std::stoi(value);
+
+                    return number >= 0 && number < 1000000;
+
+                } catch (...) {
+                    return false;
+                }
+            });
+        }
+    }
+}
+
+void buildCheckedSchema(ArgParser& parser, std::size_t optionCount) {
+
+    for (std::size_t i = 0; i < optionCount; ++i) {
+        const auto name = argumentName(i);
+
+        if (isFlagIndex(i)) {
+            parser.addFlag("", name, "Generated flag");
+            continue;
+        }
+
+        parser.addOption("", name, "Generated option", "0").range(0, 999999);
+    }
+}
+
+GeneratedArgv::GeneratedArgv(std::size_t optionCount, std::size_t tokenCount) {
+    m_tokens.reserve(tokenCount + 1);
+    m_tokens.emplace_back("generated");
+
+    std::size_t option = 0;
+    std::size_t flag = 1;
+
+    auto nextOption = [&] {
+
+        do {
+            option = (option + 1) % optionCount;
+        } while (isFlagIndex(option));
+
+        return argumentName(option);
+    };
+
+    auto nextFlag = [&] {
+        flag = optionCount > 1 ? (flag + 4) % optionCount : 0;
+
+        return isFlagIndex(flag) ? argumentName(flag) : nextOption();
+    };
+
+    for (std::size_t i = 0; m_tokens.size() <= tokenCount; ++i) {
+
+        switch (i % 4) {
+        case 0:
+            m_tokens.push_back("--" + nextOption() + "=" + std::to_string(i));
+            break;
+        case 1: {
+            const auto name = nextFlag();
+            m_tokens.push_back("--" + name);
+
+            if (!name.starts_with("flag-")) {
+                m_tokens.push_back(std::to_string(i));
+            }
+            break;
+        }
+        case 2:
+            m_tokens.push_back("--" + nextOption());
+            m_tokens.push_back(std::to_string(i));
+            break;
+        default:
+            m_tokens.push_back("/data/input/shard-" + std::to_string(i) + ".bin");
+            break;
+        }
+    }
+
+    m_argv.reserve(m_tokens.size());
+
+    for (auto& token : m_tokens) {
+        m_argv.push_back(token.data());
+        m_bytes += token.size() + 1;
+    }
+}
+
+std::vector<std::string> GeneratedArgv::arguments() const {
+
+    return {m_tokens.begin() + 1, m_tokens.end()};
+}
+
+void reportAllocations(benchmark::State& state, std::size_t allocations, const char* counter) {
+    state.counters[counter] = benchmark::Counter(static_cast<double>(allocations),
+                                                    benchmark::Counter::kAvgIterations);
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ArgParser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace argparser::bench {
+
+// Each schema entry i is a flag when i % 4 == 1 and an option otherwise.
+[[nodiscard]] bool isFlagIndex(std::size_t index) noexcept;
+[[nodiscard]] std::string argumentName(std::size_t index);
+
+// Fills the parser with optionCount generated arguments. With validators, every
+// option gets a std::function that checks the value is a bounded integer.
+void buildSchema(ArgParser& parser, std::size_t optionCount, bool withValidators = false);
+// Same schema with the bound checked by the built-in range() check instead.
+void buildCheckedSchema(ArgParser& parser, std::size_t optionCount);
+
+// Owns the strings behind a generated argv for a schema built by buildSchema().
+// Tokens cycle through "--option-i=value", "--flag-j", "--option-k value" and
+// positional paths.
+class GeneratedArgv {
+public:
+    GeneratedArgv(std::size_t optionCount, std::size_t tokenCount);
+
+    [[nodiscard]] int argc() const noexcept { return static_cast<int>(m_argv.size()); }
+    [[nodiscard]] char** argv() noexcept { return m_argv.data(); }
+    [[nodiscard]] const std::vector<std::string>& tokens() const noexcept { return m_tokens; }
+    [[nodiscard]] std::vector<std::string> arguments() const;
+    [[nodiscard]] std::size_t bytes() const noexcept { return m_bytes; }
+
+private:
+    std::vector<std::string> m_tokens;
+    std::vector<char*> m_argv;
+    std::size_t m_bytes = 0;
+};
+
+void reportAllocations(benchmark::State& state, std::size_t allocations,
+                        const char* counter = "allocs/parse");
+
+}
@@ -0,0 +1,53 @@
+#include "ArgParser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+using argparser::ArgParser;
+using argparser::ParseResult;
+
+const ArgParser& sharedSchema() {
+    static const ArgParser parser = [] {
+        ArgParser schema("client");
+        schema.addFlag("v", "verbose", "Enable verbose output");
+        schema.addOption("o", "output", "Output file", "out.txt");
+        schema.addOption("t", "threads", "Worker threads", "4");
+        schema.addOption("", "request-identifier", "Request identifier");
+        schema.addPositional("input", "Input file", true);
+
+        return schema;
+    }();
+
+    return parser;
+}
+
+void BM_ConcurrentParse(benchmark::State& state) {
+    const auto& schema = sharedSchema();
+
+    std::vector<std::string> tokens = {
+        "client", "--verbose", "--output=/tmp/client-output.txt", "-t", "8",
+        "--request-identifier", "3f2504e0-4f89-11d3-9a0c-0305e82c3301", "/data/input.bin",
+    };
+    std::vector<char*> argv;
+
+    for (auto& token : tokens) {
+        argv.push_back(token.data());
+    }
+
+    ParseResult result;
+
+    for (auto _ : state) {
+        schema.parseOptions(static_cast<int>(argv.size()), argv.data(), result);
+        benchmark::DoNotOptimize(result.isSet("verbose"));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+}
+
+BENCHMARK(BM_ConcurrentParse)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,98 @@
+#include "AllocationCounter.hpp"
+
+#include "Converter.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using argparser::ByteSize;
+using argparser::bench::AllocationScope;
+
+std::vector<std::string> makeTokens(const char* suffix) {
+    std::vector<std::string> tokens;
+
+    for (int i = 0; i < 256; ++i) {
+        tokens.push_back(std::to_string(i * 7919 % 100000) + suffix);
+    }
+
+    return tokens;
+}
+
+template <typename Convert>
+void runConversions(benchmark::State& state, const std::vector<std::string>& tokens, Convert convert) {
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+
+        for (const auto& token : tokens) {
+            benchmark::DoNotOptimize(convert(token));
+        }
+        allocations += scope.count();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * tokens.size()));
+    state.counters["allocs/iteration"] = benchmark::Counter(static_cast<double>(allocations),
+                                                            benchmark::Counter::kAvgIterations);
+}
+
+template <typename T>
+T convertOrZero(const std::string& token) {
+    T value{};
+    (void)argparser::convertValue(token, value);
+
+    return value;
+}
+
+// The std::stoi/std::stod path get<T>() used before Converter; the string
+// copy was part of it, since stoi takes a std::string.
+void BM_ConvertIntStoi(benchmark::State& state) {
+    runConversions(state, makeTokens(""), [](const std::string& token) {
+        try {
+            return std::stoi(std::string(token));
+        } catch (...) {
+            return 0;
+        }
+    });
+}
+
+void BM_ConvertDoubleStod(benchmark::State& state) {
+    runConversions(state, makeTokens(".125"), [](const std::string& token) {
+        try {
+            return std::stod(std::string(token));
+        } catch (...) {
+            return 0.0;
+        }
+    });
+}
+
+void BM_ConvertInt(benchmark::State& state) {
+    runConversions(state, makeTokens(""), convertOrZero<int>);
+}
+
+void BM_ConvertDouble(benchmark::State& state) {
+    runConversions(state, makeTokens(".125"), convertOrZero<double>);
+}
+
+void BM_ConvertDuration(benchmark::State& state) {
+    runConversions(state, makeTokens("ms"), convertOrZero<std::chrono::microseconds>);
+}
+
+void BM_ConvertByteSize(benchmark::State& state) {
+    runConversions(state, makeTokens("KiB"), convertOrZero<ByteSize>);
+}
+
+}
+
+BENCHMARK(BM_ConvertIntStoi);
+BENCHMARK(BM_ConvertDoubleStod);
+BENCHMARK(BM_ConvertInt);
+BENCHMARK(BM_ConvertDouble);
+BENCHMARK(BM_ConvertDuration);
+BENCHMARK(BM_ConvertByteSize);
@@ -0,0 +1,119 @@
+#include "AllocationCounter.hpp"
+
+#include "ArgParser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+namespace {
+
+using argparser::ArgParser;
+using argparser::bench::AllocationScope;
+
+ArgParser& typedSchema() {
+    static ArgParser parser = [] {
+        ArgParser schema("typed");
+        schema.addOption("s", "name", "String option", "a-string-longer-than-sso-buffers");
+        schema.addOption("i", "count", "Integer option", "123456");
+        schema.addOption("d", "ratio", "Floating point option", "0.123456789");
+        schema.addOption("b", "enabled", "Boolean option", "Yes");
+
+        return schema;
+    }();
+
+    return parser;
+}
+
+template <typename T>
+void runGet(benchmark::State& state, const char* name) {
+    auto& parser = typedSchema();
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        benchmark::DoNotOptimize(parser.get<T>(name));
+        allocations += scope.count();
+    }
+
+    state.counters["allocs/get"] = benchmark::Counter(static_cast<double>(allocations),
+                                                        benchmark::Counter::kAvgIterations);
+}
+
+template <typename T>
+void runGetAfterParse(benchmark::State& state, const char* name, const char* value) {
+    auto& parser = typedSchema();
+    std::string program = "typed";
+    std::string token = std::string("--") + name + "=" + value;
+    char* argv[] = {program.data(), token.data()};
+
+    for (auto _ : state) {
+        parser.reset();
+        parser.parseOptions(2, argv);
+        benchmark::DoNotOptimize(parser.get<T>(name));
+    }
+}
+
+struct Config {
+    int count = 0;
+    double ratio = 0;
+    bool enabled = false;
+};
+
+// Rebuilding a config struct after each parse: by name through the hash map
+// and string conversion, or written during the parse by bind().
+void BM_ConfigByName(benchmark::State& state) {
+    ArgParser parser("typed");
+    parser.addOption("i", "count", "Integer option");
+    parser.addOption("d", "ratio", "Floating point option");
+    parser.addFlag("b", "enabled", "Boolean flag");
+    std::string program = "typed", count = "--count=654321", ratio = "--ratio=9.87654321", flag = "-b";
+    char* argv[] = {program.data(), count.data(), ratio.data(), flag.data()};
+    Config config;
+
+    for (auto _ : state) {
+        parser.reset();
+        parser.parseOptions(4, argv);
+        config.count = parser.getInt("count");
+        config.ratio = parser.getDouble("ratio");
+        config.enabled = parser.getBool("enabled");
+        benchmark::DoNotOptimize(config);
+    }
+}
+
+void BM_ConfigBound(benchmark::State& state) {
+    ArgParser parser("typed");
+    Config config;
+    parser.addOption("i", "count", "Integer option").bind(config.count);
+    parser.addOption("d", "ratio", "Floating point option").bind(config.ratio);
+    parser.addFlag("b", "enabled", "Boolean flag").bind(config.enabled);
+    std::string program = "typed", count = "--count=654321", ratio = "--ratio=9.87654321", flag = "-b";
+    char* argv[] = {program.data(), count.data(), ratio.data(), flag.data()};
+
+    for (auto _ : state) {
+        parser.reset();
+        parser.parseOptions(4, argv);
+        benchmark::DoNotOptimize(config);
+    }
+}
+
+void BM_GetString(benchmark::State& state) { runGet<std::string>(state, "name"); }
+void BM_GetInt(benchmark::State& state) { runGet<int>(state, "count"); }
+void BM_GetDouble(benchmark::State& state) { runGet<double>(state, "ratio"); }
+void BM_GetBool(benchmark::State& state) { runGet<bool>(state, "enabled"); }
+
+void BM_GetIntAfterParse(benchmark::State& state) { runGetAfterParse<int>(state, "count", "654321"); }
+void BM_GetDoubleAfterParse(benchmark::State& state) { runGetAfterParse<double>(state, "ratio", "9.87654321"); }
+void BM_GetBoolAfterParse(benchmark::State& state) { runGetAfterParse<bool>(state, "enabled", "off"); }
+
+}
+
+BENCHMARK(BM_GetString);
+BENCHMARK(BM_GetInt);
+BENCHMARK(BM_GetDouble);
+BENCHMARK(BM_GetBool);
+BENCHMARK(BM_GetIntAfterParse);
+BENCHMARK(BM_GetDoubleAfterParse);
+BENCHMARK(BM_GetBoolAfterParse);
+BENCHMARK(BM_ConfigByName);
+BENCHMARK(BM_ConfigBound);
@@ -0,0 +1,85 @@
+#include "AllocationCounter.hpp"
+#include "BenchSupport.hpp"
+
+#include "ArgParser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+namespace {
+
+using argparser::ArgParser;
+using argparser::bench::AllocationScope;
+using argparser::bench::buildSchema;
+using argparser::bench::reportAllocations;
+
+void BM_Help(benchmark::State& state) {
+    ArgParser parser("generated", "Generated schema used to benchmark help rendering");
+    buildSchema(parser, static_cast<std::size_t>(state.range(0)));
+    parser.addPositional("input", "Input file", true);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        benchmark::DoNotOptimize(parser.help());
+        allocations += scope.count();
+    }
+
+    reportAllocations(state, allocations, "allocs/help");
+}
+
+void BM_FormatHelp(benchmark::State& state) {
+    ArgParser parser("generated", "Generated schema used to benchmark help rendering");
+    buildSchema(parser, static_cast<std::size_t>(state.range(0)));
+    parser.addPositional("input", "Input file", true);
+
+    std::string out;
+    parser.formatHelp(out);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        out.clear();
+        parser.formatHelp(out);
+        allocations += scope.count();
+
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    reportAllocations(state, allocations, "allocs/help");
+}
+
+
+// A --help request answered into a reserved buffer, without leaving the parse.
+void BM_HelpRequestIntoSink(benchmark::State& state) {
+    ArgParser parser("generated", "Generated schema used to benchmark help rendering");
+    buildSchema(parser, static_cast<std::size_t>(state.range(0)));
+    parser.addPositional("input", "Input file", true);
+
+    std::string out;
+    argparser::StringSink sink(out);
+    parser.output(&sink).exitOnHelp(false);
+
+    char program[] = "generated";
+    char help[] = "--help";
+    char* argv[] = {program, help};
+    argparser::ParseResult result;
+    parser.parseOptions(2, argv, result);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        out.clear();
+        parser.parseOptions(2, argv, result);
+        allocations += scope.count();
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    reportAllocations(state, allocations, "allocs/help");
+}
+}
+
+BENCHMARK(BM_Help)->ArgName("options")->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_FormatHelp)->ArgName("options")->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_HelpRequestIntoSink)->ArgName("options")->Arg(10)->Arg(100)->Arg(1000);
@@ -0,0 +1,100 @@
+#include "AllocationCounter.hpp"
+#include "BenchSupport.hpp"
+
+#include "ArgParser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using argparser::ArgParser;
+using argparser::bench::AllocationScope;
+using argparser::bench::reportAllocations;
+
+void runLookups(benchmark::State& state, std::string_view prefix) {
+    const auto optionCount = static_cast<std::size_t>(state.range(0));
+    std::vector<std::string> names;
+    names.reserve(optionCount);
+
+    ArgParser parser("lookup");
+
+    for (std::size_t i = 0; i < optionCount; ++i) {
+        names.push_back(std::string(prefix) + std::to_string(i));
+        parser.addOption("", names.back(), "Generated option", "1");
+    }
+
+    std::vector<std::string_view> queries(names.begin(), names.end());
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+
+        for (auto query : queries) {
+            benchmark::DoNotOptimize(parser.isSet(query));
+        }
+        allocations += scope.count();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * queries.size()));
+    reportAllocations(state, allocations, "allocs/pass");
+}
+
+void BM_FindArgumentShortName(benchmark::State& state) {
+    runLookups(state, "opt");
+}
+
+void BM_FindArgumentLongName(benchmark::State& state) {
+    runLookups(state, "service-configuration-option-");
+}
+
+void BM_ResolveAbbreviation(benchmark::State& state) {
+    const auto optionCount = static_cast<std::size_t>(state.range(0));
+    ArgParser parser("lookup");
+
+    for (std::size_t i = 0; i < optionCount; ++i) {
+        parser.addOption("", "option-" + std::to_string(i) + "-threshold", "Generated option", "1");
+    }
+    parser.allowAbbreviations().freeze();
+
+    std::string program = "lookup";
+    std::string token = "--option-" + std::to_string(optionCount / 2) + "-thr=2";
+    char* argv[] = {program.data(), token.data()};
+
+    argparser::ParseResult result;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.tryParse(2, argv, result));
+    }
+}
+
+void BM_SuggestUnknownLongName(benchmark::State& state) {
+    const auto optionCount = static_cast<std::size_t>(state.range(0));
+    ArgParser parser("lookup");
+
+    for (std::size_t i = 0; i < optionCount; ++i) {
+        parser.addOption("", "service-configuration-option-" + std::to_string(i), "Generated option", "1");
+    }
+    parser.freeze();
+
+    std::string program = "lookup";
+    std::string token = "--service-configuraton-option-7";
+    char* argv[] = {program.data(), token.data()};
+
+    argparser::ParseResult result;
+
+    for (auto _ : state) {
+        auto error = parser.tryParse(2, argv, result);
+        benchmark::DoNotOptimize(error->message());
+    }
+}
+
+}
+
+BENCHMARK(BM_ResolveAbbreviation)->ArgName("options")->Arg(10)->Arg(100)->Arg(2000);
+BENCHMARK(BM_SuggestUnknownLongName)->ArgName("options")->Arg(10)->Arg(100)->Arg(2000);
+BENCHMARK(BM_FindArgumentShortName)->ArgName("options")->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_FindArgumentLongName)->ArgName("options")->Arg(10)->Arg(100)->Arg(1000);
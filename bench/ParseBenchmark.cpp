@@ -0,0 +1,236 @@
+#include "AllocationCounter.hpp"
+#include "BenchSupport.hpp"
+
+#include "ArgParser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using argparser::ArgParser;
+using argparser::ParseResult;
+using argparser::bench::AllocationScope;
+using argparser::bench::GeneratedArgv;
+using argparser::bench::buildSchema;
+using argparser::bench::reportAllocations;
+
+void parseArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"options", "tokens"});
+
+    for (const std::int64_t options : {10, 100, 1000}) {
+
+        for (const std::int64_t tokens : {10, 100, 1000, 10000, 100000}) {
+            bench->Args({options, tokens});
+        }
+    }
+}
+
+void BM_ParseOptions(benchmark::State& state) {
+    const auto optionCount = static_cast<std::size_t>(state.range(0));
+    GeneratedArgv argv(optionCount, static_cast<std::size_t>(state.range(1)));
+
+    ArgParser parser("generated");
+    buildSchema(parser, optionCount);
+    parser.parseOptions(argv.argc(), argv.argv());
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        parser.reset();
+        parser.parseOptions(argv.argc(), argv.argv());
+        allocations += scope.count();
+
+        benchmark::DoNotOptimize(parser.positionalViews().data());
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * argv.bytes()));
+    reportAllocations(state, allocations);
+}
+
+void BM_ParseOptionsIntoResult(benchmark::State& state) {
+    const auto optionCount = static_cast<std::size_t>(state.range(0));
+    GeneratedArgv argv(optionCount, static_cast<std::size_t>(state.range(1)));
+
+    ArgParser parser("generated");
+    buildSchema(parser, optionCount);
+
+    ParseResult result;
+    parser.parseOptions(argv.argc(), argv.argv(), result);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        parser.parseOptions(argv.argc(), argv.argv(), result);
+        allocations += scope.count();
+
+        benchmark::DoNotOptimize(result.positionalViews().data());
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * argv.bytes()));
+    reportAllocations(state, allocations);
+}
+
+void BM_ParsePositionalOption(benchmark::State& state) {
+    const auto optionCount = static_cast<std::size_t>(state.range(0));
+    GeneratedArgv argv(optionCount, static_cast<std::size_t>(state.range(1)));
+    const auto args = argv.arguments();
+
+    ArgParser parser("generated");
+    buildSchema(parser, optionCount);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        parser.reset();
+        parser.parsePositionalOption(args);
+        allocations += scope.count();
+
+        benchmark::DoNotOptimize(parser.positionalViews().data());
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * argv.bytes()));
+    reportAllocations(state, allocations);
+}
+
+void BM_ParseStreamingPositionals(benchmark::State& state) {
+    GeneratedArgv argv(10, static_cast<std::size_t>(state.range(0)));
+
+    ArgParser parser("generated");
+    buildSchema(parser, 10);
+
+    std::size_t consumed = 0;
+    parser.onPositional([&consumed](std::string_view path) { consumed += path.size(); });
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        parser.reset();
+        parser.parseOptions(argv.argc(), argv.argv());
+        allocations += scope.count();
+    }
+
+    benchmark::DoNotOptimize(consumed);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * argv.bytes()));
+    reportAllocations(state, allocations);
+}
+
+// "-I dir-i" repeated; an append() option keeps every occurrence as a view.
+void BM_ParseRepeatedOption(benchmark::State& state) {
+    const auto occurrences = static_cast<std::size_t>(state.range(0));
+    std::vector<std::string> tokens{"generated"};
+    std::size_t bytes = 0;
+
+    for (std::size_t i = 0; i < occurrences; ++i) {
+        tokens.emplace_back("-I");
+        tokens.push_back("dir-" + std::to_string(i));
+        bytes += tokens.back().size() + 2;
+    }
+
+    std::vector<char*> argv;
+
+    for (auto& token : tokens) {
+        argv.push_back(token.data());
+    }
+
+    ArgParser parser("generated");
+    parser.addOption("I", "include", "Include directory").append();
+    ParseResult result;
+    parser.parseOptions(static_cast<int>(argv.size()), argv.data(), result);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        parser.parseOptions(static_cast<int>(argv.size()), argv.data(), result);
+        allocations += scope.count();
+
+        benchmark::DoNotOptimize(result.get<std::span<const std::string_view>>("include"));
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+    reportAllocations(state, allocations);
+}
+
+void BM_ParseResponseFile(benchmark::State& state) {
+    const auto optionCount = static_cast<std::size_t>(state.range(0));
+    GeneratedArgv generated(optionCount, static_cast<std::size_t>(state.range(1)));
+    const auto path = std::filesystem::temp_directory_path() / "argparser_bench_args.txt";
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        const auto& tokens = generated.tokens();
+
+        for (std::size_t i = 1; i < tokens.size(); ++i) {
+            out << tokens[i] << '\n';
+        }
+    }
+
+    std::string program = "generated";
+    std::string token = "@" + path.string();
+    char* argv[] = {program.data(), token.data()};
+
+    ArgParser parser("generated");
+    buildSchema(parser, optionCount);
+    parser.responseFiles();
+
+    ParseResult result;
+    parser.parseOptions(2, argv, result);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        parser.parseOptions(2, argv, result);
+        allocations += scope.count();
+
+        benchmark::DoNotOptimize(result.positionalViews().data());
+    }
+
+    std::filesystem::remove(path);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * generated.bytes()));
+    reportAllocations(state, allocations);
+}
+
+void BM_ParseOptionsUnknownThrow(benchmark::State& state) {
+    std::vector<std::string> tokens = {"generated", "--option-0=1", "--no-such-option"};
+    std::vector<char*> argv = {tokens[0].data(), tokens[1].data(), tokens[2].data()};
+
+    ArgParser parser("generated");
+    buildSchema(parser, 10);
+
+    for (auto _ : state) {
+
+        try {
+            parser.parseOptions(static_cast<int>(argv.size()), argv.data());
+        } catch (const argparser::ArgumentError& e) {
+            benchmark::DoNotOptimize(e.what());
+        }
+    }
+}
+
+void BM_TryParseUnknown(benchmark::State& state) {
+    std::vector<std::string> tokens = {"generated", "--option-0=1", "--no-such-option"};
+    std::vector<char*> argv = {tokens[0].data(), tokens[1].data(), tokens[2].data()};
+
+    ArgParser parser("generated");
+    buildSchema(parser, 10);
+
+    for (auto _ : state) {
+        auto error = parser.tryParse(static_cast<int>(argv.size()), argv.data());
+        benchmark::DoNotOptimize(error);
+    }
+}
+
+}
+
+BENCHMARK(BM_ParseOptions)->Apply(parseArgs);
+BENCHMARK(BM_ParseOptionsIntoResult)->Apply(parseArgs);
+BENCHMARK(BM_ParsePositionalOption)->Apply(parseArgs);
+BENCHMARK(BM_ParseStreamingPositionals)->ArgName("tokens")->Arg(1000)->Arg(100000)->Arg(1000000);
+BENCHMARK(BM_ParseRepeatedOption)->ArgName("occurrences")->Arg(10)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_ParseResponseFile)->Apply(parseArgs);
+BENCHMARK(BM_ParseOptionsUnknownThrow);
+BENCHMARK(BM_TryParseUnknown);
@@ -0,0 +1,317 @@
+#include "AllocationCounter.hpp"
+
+#include "ArgParser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace {
+
+using argparser::ArgParser;
+using argparser::bench::AllocationScope;
+
+std::vector<std::string> makeOptionNames(std::size_t count) {
+    std::vector<std::string> names;
+    names.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        names.push_back("tool-invocation-option-" + std::to_string(i));
+    }
+
+    return names;
+}
+
+void buildSchema(ArgParser& parser, const std::vector<std::string>& names) {
+
+    for (const auto& name : names) {
+        parser.addOption("", name, "Option generated for the schema construction benchmark", "default");
+    }
+}
+
+void BM_BuildSchemaDefaultResource(benchmark::State& state) {
+    const auto names = makeOptionNames(static_cast<std::size_t>(state.range(0)));
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        {
+            ArgParser parser("tool");
+            buildSchema(parser, names);
+            benchmark::DoNotOptimize(parser.isSet(names.front()));
+        }
+        allocations += scope.count();
+    }
+
+    state.counters["allocs/schema"] = benchmark::Counter(
+        static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+void BM_BuildSchemaMonotonicArena(benchmark::State& state) {
+    const auto names = makeOptionNames(static_cast<std::size_t>(state.range(0)));
+    std::vector<std::byte> buffer(1 << 20);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+                                                    std::pmr::null_memory_resource());
+        {
+            ArgParser parser("tool", "", &arena);
+            buildSchema(parser, names);
+            benchmark::DoNotOptimize(parser.isSet(names.front()));
+        }
+        arena.release();
+        allocations += scope.count();
+    }
+
+    state.counters["allocs/schema"] = benchmark::Counter(
+        static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+// Same schema as BM_BuildSchemaDefaultResource with its size announced up
+// front, so the argument table and the string pool are sized once.
+void BM_BuildSchemaReserved(benchmark::State& state) {
+    const auto names = makeOptionNames(static_cast<std::size_t>(state.range(0)));
+    std::size_t textBytes = 0;
+
+    for (const auto& name : names) {
+        textBytes += name.size();
+    }
+
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        {
+            ArgParser parser("tool");
+            parser.reserve(names.size(), textBytes + 64);
+            buildSchema(parser, names);
+            benchmark::DoNotOptimize(parser.isSet(names.front()));
+        }
+        allocations += scope.count();
+    }
+
+    state.counters["allocs/schema"] = benchmark::Counter(
+        static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+void BM_ParseAgainstLargeSchema(benchmark::State& state) {
+    const auto names = makeOptionNames(static_cast<std::size_t>(state.range(0)));
+    ArgParser parser("tool");
+    buildSchema(parser, names);
+    parser.addOption("", "required-option", "Required option").required(true);
+    parser.addPositional("input", "Input file", true);
+
+    std::vector<std::string> tokens = {"tool", "--required-option", "value", "--" + names.back(), "x", "in.bin"};
+    std::vector<char*> argv;
+
+    for (auto& token : tokens) {
+        argv.push_back(token.data());
+    }
+
+    argparser::ParseResult result;
+
+    for (auto _ : state) {
+        parser.parseOptions(static_cast<int>(argv.size()), argv.data(), result);
+        benchmark::DoNotOptimize(result.positionalViews().data());
+    }
+}
+
+// Process startup for a tool with state.range(0) options: get the schema
+// ready and parse one command line, either by building it with addOption()
+// or by loading a blob written by freeze(blob).
+void BM_StartupBuildSchema(benchmark::State& state) {
+    const auto names = makeOptionNames(static_cast<std::size_t>(state.range(0)));
+    std::vector<std::string> tokens = {"tool", "--" + names.back(), "x", "in.bin"};
+    std::vector<char*> argv;
+
+    for (auto& token : tokens) {
+        argv.push_back(token.data());
+    }
+
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        {
+            ArgParser parser("tool");
+            buildSchema(parser, names);
+            parser.addPositional("input", "Input file", true);
+            argparser::ParseResult result;
+            parser.parseOptions(static_cast<int>(argv.size()), argv.data(), result);
+            benchmark::DoNotOptimize(result.positionalViews().data());
+        }
+        allocations += scope.count();
+    }
+
+    state.counters["allocs/startup"] = benchmark::Counter(
+        static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+void BM_StartupFromBlob(benchmark::State& state) {
+    const auto names = makeOptionNames(static_cast<std::size_t>(state.range(0)));
+    std::string blob;
+    {
+        ArgParser parser("tool");
+        buildSchema(parser, names);
+        parser.addPositional("input", "Input file", true);
+        parser.freeze(blob);
+    }
+
+    std::vector<std::string> tokens = {"tool", "--" + names.back(), "x", "in.bin"};
+    std::vector<char*> argv;
+
+    for (auto& token : tokens) {
+        argv.push_back(token.data());
+    }
+
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        {
+            const argparser::CompiledSchema schema(blob);
+            argparser::CompiledResult result;
+            schema.parseOptions(static_cast<int>(argv.size()), argv.data(), result);
+            benchmark::DoNotOptimize(result.positionalViews().data());
+        }
+        allocations += scope.count();
+    }
+
+    state.counters["allocs/startup"] = benchmark::Counter(
+        static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+    state.counters["blob_bytes"] = static_cast<double>(blob.size());
+}
+
+
+// A service started with a value for every one of its state.range(0)
+// options, either spelled out in argv or read from a config file.
+void BM_StartupOptionsInArgv(benchmark::State& state) {
+    const auto names = makeOptionNames(static_cast<std::size_t>(state.range(0)));
+    std::vector<std::string> tokens = {"tool"};
+
+    for (const auto& name : names) {
+        tokens.push_back("--" + name + "=value");
+    }
+
+    std::vector<char*> argv;
+
+    for (auto& token : tokens) {
+        argv.push_back(token.data());
+    }
+
+    for (auto _ : state) {
+        ArgParser parser("tool");
+        buildSchema(parser, names);
+        argparser::ParseResult result;
+        parser.parseOptions(static_cast<int>(argv.size()), argv.data(), result);
+        benchmark::DoNotOptimize(result.positionalViews().data());
+    }
+}
+
+void BM_StartupOptionsInConfig(benchmark::State& state) {
+    const auto names = makeOptionNames(static_cast<std::size_t>(state.range(0)));
+    const auto path = (std::filesystem::temp_directory_path() / "argparser_bench_startup.ini").string();
+    {
+        std::ofstream config(path);
+
+        for (const auto& name : names) {
+            config << name << " = value\n";
+        }
+    }
+
+    char program[] = "tool";
+    char* argv[] = {program};
+
+    for (auto _ : state) {
+        ArgParser parser("tool");
+        buildSchema(parser, names);
+        parser.loadConfig(path);
+        argparser::ParseResult result;
+        parser.parseOptions(1, argv, result);
+        benchmark::DoNotOptimize(result.positionalViews().data());
+    }
+
+    std::filesystem::remove(path);
+}
+}
+
+// Startup plus one parse for a tool with state.range(0) subcommands of 20
+// options each; the eager variant builds every sub-schema up front.
+constexpr std::size_t subcommandOptions = 20;
+
+void BM_SubcommandsEager(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto names = makeOptionNames(subcommandOptions);
+    std::vector<std::string> tokens{"tool", "command-0", "--" + names.front(), "value"};
+    std::vector<char*> argv;
+
+    for (auto& token : tokens) {
+        argv.push_back(token.data());
+    }
+
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        std::vector<ArgParser> parsers;
+        parsers.reserve(count);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            buildSchema(parsers.emplace_back("tool command-" + std::to_string(i)), names);
+        }
+        parsers.front().parseOptions(static_cast<int>(argv.size()) - 1, argv.data() + 1);
+        benchmark::DoNotOptimize(parsers.front().isSet(names.front()));
+        allocations += scope.count();
+    }
+
+    state.counters["allocs/startup"] = benchmark::Counter(
+        static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+void BM_SubcommandsLazy(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto names = makeOptionNames(subcommandOptions);
+    std::vector<std::string> tokens{"tool", "command-0", "--" + names.front(), "value"};
+    std::vector<char*> argv;
+
+    for (auto& token : tokens) {
+        argv.push_back(token.data());
+    }
+
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        ArgParser parser("tool");
+
+        for (std::size_t i = 0; i < count; ++i) {
+            parser.addSubcommand("command-" + std::to_string(i),
+                                [&names](ArgParser& sub) { buildSchema(sub, names); });
+        }
+        parser.parseOptions(static_cast<int>(argv.size()), argv.data());
+        benchmark::DoNotOptimize(parser.subcommandParser("command-0")->isSet(names.front()));
+        allocations += scope.count();
+    }
+
+    state.counters["allocs/startup"] = benchmark::Counter(
+        static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_ParseAgainstLargeSchema)->Arg(10)->Arg(512)->Arg(2048);
+BENCHMARK(BM_BuildSchemaDefaultResource)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_BuildSchemaMonotonicArena)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_BuildSchemaReserved)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_StartupBuildSchema)->Arg(100)->Arg(2000);
+BENCHMARK(BM_StartupFromBlob)->Arg(100)->Arg(2000);
+BENCHMARK(BM_StartupOptionsInArgv)->Arg(300);
+BENCHMARK(BM_StartupOptionsInConfig)->Arg(300);
+BENCHMARK(BM_SubcommandsEager)->Arg(1)->Arg(40);
+BENCHMARK(BM_SubcommandsLazy)->Arg(1)->Arg(40);
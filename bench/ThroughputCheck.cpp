@@ -0,0 +1,170 @@
+#include "BenchSupport.hpp"
+
+#include "ArgParser.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+
+// Measures how many MB of argv per second each parse path gets through and
+// compares the numbers with a recorded baseline:
+//
+//     argparser_throughput_check --baseline FILE [--threshold PERCENT] [--update]
+//
+// Exits with 1 if a path got slower than the baseline by more than the
+// threshold (10% by default). --update records the current numbers instead.
+// Baselines only compare across builds on the same machine.
+namespace {
+
+using argparser::ArgParser;
+using argparser::ParseResult;
+using argparser::bench::GeneratedArgv;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t optionCount = 100;
+constexpr std::size_t tokenCount = 10000;
+constexpr int rounds = 5;
+constexpr auto roundTime = std::chrono::milliseconds(200);
+
+// Best of several rounds, since a regression check cares about the code and
+// not about whatever else the machine was doing.
+template <typename Parse>
+double measure(GeneratedArgv& argv, Parse&& parse) {
+    double best = 0;
+
+    for (int round = 0; round < rounds; ++round) {
+        std::size_t parses = 0;
+        const auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+
+        while (elapsed < roundTime) {
+            parse(argv);
+            ++parses;
+            elapsed = Clock::now() - start;
+        }
+
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        best = std::max(best, static_cast<double>(parses * argv.bytes()) / seconds / 1e6);
+    }
+
+    return best;
+}
+
+std::map<std::string, double> run() {
+    GeneratedArgv argv(optionCount, tokenCount);
+    std::map<std::string, double> results;
+
+    ArgParser parser("generated");
+    argparser::bench::buildSchema(parser, optionCount);
+    parser.freeze();
+
+    results["parser-state"] = measure(argv, [&parser](GeneratedArgv& line) {
+        parser.reset();
+        parser.parseOptions(line.argc(), line.argv());
+    });
+
+    ParseResult result;
+    results["parse-result"] = measure(argv, [&parser, &result](GeneratedArgv& line) {
+        parser.parseOptions(line.argc(), line.argv(), result);
+    });
+
+    ArgParser lazy("generated");
+    argparser::bench::buildSchema(lazy, optionCount);
+    lazy.lazy();
+    lazy.freeze();
+
+    results["lazy"] = measure(argv, [&lazy, &result](GeneratedArgv& line) {
+        lazy.parseOptions(line.argc(), line.argv(), result);
+    });
+
+    ArgParser checked("generated");
+    argparser::bench::buildCheckedSchema(checked, optionCount);
+    checked.freeze();
+
+    results["checked"] = measure(argv, [&checked, &result](GeneratedArgv& line) {
+        checked.parseOptions(line.argc(), line.argv(), result);
+    });
+
+    return results;
+}
+
+std::map<std::string, double> readBaseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream file(path);
+    std::string name;
+    double value = 0;
+
+    while (file >> name >> value) {
+        baseline[name] = value;
+    }
+
+    return baseline;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string baselinePath;
+    double threshold = 10;
+    bool update = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+
+        if (arg == "--baseline" && i + 1 < argc) {
+            baselinePath = argv[++i];
+
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            threshold = std::atof(argv[++i]);
+
+        } else if (arg == "--update") {
+            update = true;
+
+        } else {
+            std::cerr << "usage: " << argv[0] << " --baseline FILE [--threshold PERCENT] [--update]\n";
+
+            return 2;
+        }
+    }
+
+    const auto results = run();
+
+    if (update) {
+        std::ofstream file(baselinePath);
+
+        for (const auto& [name, value] : results) {
+            file << name << ' ' << value << '\n';
+            std::cout << name << ": " << value << " MB/s (recorded)\n";
+        }
+
+        return file ? 0 : 1;
+    }
+
+    const auto baseline = readBaseline(baselinePath);
+    bool regressed = false;
+
+    if (baseline.empty()) {
+        std::cout << "no baseline in '" << baselinePath << "'; run with --update to record one\n";
+    }
+
+    for (const auto& [name, value] : results) {
+        std::cout << name << ": " << value << " MB/s";
+
+        if (auto it = baseline.find(name); it != baseline.end()) {
+            const double change = (value / it->second - 1) * 100;
+            const bool slower = change < -threshold;
+            regressed = regressed || slower;
+
+            std::cout << " (baseline " << it->second << ", " << (change >= 0 ? "+" : "") << change << "%"
+                        << (slower ? ", REGRESSION" : "") << ")";
+        }
+        std::cout << "\n";
+    }
+
+    return regressed ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+#include "Tokenizer.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+
+namespace {
+
+using argparser::Token;
+using argparser::TokenKind;
+
+std::string makeLongOption(std::size_t keyLength) {
+
+    return "--" + std::string(keyLength, 'k') + "=" + std::string(16, 'v');
+}
+
+// The split parseLongOption did before the tokenizer stage existed.
+Token splitWithFind(std::string_view arg) noexcept {
+    Token token;
+    token.kind = TokenKind::Long;
+    const auto eqPos = arg.find('=');
+
+    if (eqPos != std::string_view::npos) {
+        token.key = arg.substr(2, eqPos - 2);
+        token.value = arg.substr(eqPos + 1);
+        token.hasValue = true;
+    } else {
+        token.key = arg.substr(2);
+    }
+
+    return token;
+}
+
+void BM_SplitLongOptionFind(benchmark::State& state) {
+    const auto arg = makeLongOption(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        std::string_view view = arg;
+        benchmark::DoNotOptimize(view);
+        benchmark::DoNotOptimize(splitWithFind(view));
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * arg.size()));
+}
+
+void BM_SplitLongOptionTokenizer(benchmark::State& state) {
+    const auto arg = makeLongOption(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        std::string_view view = arg;
+        benchmark::DoNotOptimize(view);
+        benchmark::DoNotOptimize(argparser::splitToken(view));
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * arg.size()));
+}
+
+}
+
+BENCHMARK(BM_SplitLongOptionFind)->ArgName("key")->Arg(8)->Arg(64)->Arg(1024)->Arg(4096);
+BENCHMARK(BM_SplitLongOptionTokenizer)->ArgName("key")->Arg(8)->Arg(64)->Arg(1024)->Arg(4096);
@@ -0,0 +1,112 @@
+#include "AllocationCounter.hpp"
+#include "BenchSupport.hpp"
+
+#include "ArgParser.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using argparser::ArgParser;
+using argparser::ParseResult;
+using argparser::bench::AllocationScope;
+using argparser::bench::GeneratedArgv;
+using argparser::bench::argumentName;
+using argparser::bench::buildCheckedSchema;
+using argparser::bench::buildSchema;
+using argparser::bench::reportAllocations;
+
+void BM_ParseWithValidators(benchmark::State& state) {
+    const auto optionCount = static_cast<std::size_t>(state.range(0));
+    GeneratedArgv argv(optionCount, static_cast<std::size_t>(state.range(1)));
+
+    ArgParser parser("generated");
+    buildSchema(parser, optionCount, true);
+
+    ParseResult result;
+    parser.parseOptions(argv.argc(), argv.argv(), result);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        parser.parseOptions(argv.argc(), argv.argv(), result);
+        allocations += scope.count();
+
+        benchmark::DoNotOptimize(result.positionalViews().data());
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * argv.bytes()));
+    reportAllocations(state, allocations);
+}
+
+// range(0, 999999) in place of the std::function/stoi validator above; with
+// deferred set, the checks run in one pass after the token loop.
+void BM_ParseWithChecks(benchmark::State& state) {
+    const auto optionCount = static_cast<std::size_t>(state.range(0));
+    GeneratedArgv argv(optionCount, static_cast<std::size_t>(state.range(1)));
+
+    ArgParser parser("generated");
+    buildCheckedSchema(parser, optionCount);
+    parser.deferValidation(state.range(2) != 0);
+    parser.freeze();
+
+    ParseResult result;
+    parser.parseOptions(argv.argc(), argv.argv(), result);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        parser.parseOptions(argv.argc(), argv.argv(), result);
+        allocations += scope.count();
+
+        benchmark::DoNotOptimize(result.positionalViews().data());
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * argv.bytes()));
+    reportAllocations(state, allocations);
+}
+
+
+// A program that reads three options out of a validated schema and moves on.
+// With lazy set, only those three are validated, on their first read.
+void BM_ParseAndReadFew(benchmark::State& state) {
+    const auto optionCount = static_cast<std::size_t>(state.range(0));
+    GeneratedArgv argv(optionCount, static_cast<std::size_t>(state.range(1)));
+
+    ArgParser parser("generated");
+    buildSchema(parser, optionCount, true);
+    parser.lazy(state.range(2) != 0);
+    parser.freeze();
+
+    const std::string names[] = {argumentName(0), argumentName(2), argumentName(3)};
+    ParseResult result;
+    parser.parseOptions(argv.argc(), argv.argv(), result);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        AllocationScope scope;
+        parser.parseOptions(argv.argc(), argv.argv(), result);
+
+        for (const auto& name : names) {
+            benchmark::DoNotOptimize(result.get<int>(name));
+        }
+        allocations += scope.count();
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * argv.bytes()));
+    reportAllocations(state, allocations);
+}
+
+}
+
+BENCHMARK(BM_ParseWithValidators)
+    ->ArgNames({"options", "tokens"})
+    ->ArgsProduct({{10, 100, 1000}, {10, 1000, 100000}});
+
+BENCHMARK(BM_ParseWithChecks)
+    ->ArgNames({"options", "tokens", "deferred"})
+    ->ArgsProduct({{10, 100, 1000}, {10, 1000, 100000}, {0, 1}});
+
+BENCHMARK(BM_ParseAndReadFew)
+    ->ArgNames({"options", "tokens", "lazy"})
+    ->ArgsProduct({{100, 1000}, {100, 10000}, {0, 1}});
@@ -0,0 +1,333 @@
+#include "Differential.hpp"
+
+#include "ArgParser.hpp"
+#include "NaiveParser.hpp"
+#include "Tokenizer.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+
+namespace argparser::fuzz {
+
+namespace {
+
+// Every argument kind the token loop distinguishes: clustered short flags,
+// options with and without defaults, append() and nargs() options, a short-only
+// option and required and optional positionals. Both the library schema and
+// the naive reference are built from this table.
+const std::vector<NaiveArgument>& schemaArguments() {
+    static const std::vector<NaiveArgument> arguments = {
+        // kind, short name, long name, default, append, nargs, required
+        {NaiveKind::Flag, "v", "verbose", "", false, 1, false},
+        {NaiveKind::Flag, "q", "quiet", "", false, 1, false},
+        {NaiveKind::Option, "o", "output", "", false, 1, false},
+        {NaiveKind::Option, "n", "name", "anon", false, 1, false},
+        {NaiveKind::Option, "I", "include", "", true, 1, false},
+        {NaiveKind::Option, "", "point", "", false, 2, false},
+        {NaiveKind::Option, "x", "", "", false, 1, false},
+        {NaiveKind::Option, "", "level", "1", false, 1, false},
+        {NaiveKind::Positional, "", "input", "", false, 1, true},
+        {NaiveKind::Positional, "", "extra", "", false, 1, false},
+    };
+
+    return arguments;
+}
+
+class DiscardSink final : public OutputSink {
+public:
+    void write(std::string_view) override {}
+};
+
+void buildSchema(ArgParser& parser) {
+    static DiscardSink discard;
+    parser.version("1.0").exitOnHelp(false).output(&discard);
+
+    for (const auto& argument : schemaArguments()) {
+
+        if (argument.kind == NaiveKind::Flag) {
+            parser.addFlag(argument.shortName, argument.longName, "Flag");
+        } else if (argument.kind == NaiveKind::Positional) {
+            parser.addPositional(argument.longName, "Positional", argument.required);
+        } else {
+            auto& option = parser.addOption(argument.shortName, argument.longName, "Option", argument.defaultValue);
+            option.append(argument.append);
+
+            if (argument.nargs != 1) {
+                option.nargs(argument.nargs);
+            }
+        }
+    }
+}
+
+struct Schemas {
+    // The schema sets a version and has no "version" argument of its own.
+    Schemas() : naive(schemaArguments(), true) {
+        buildSchema(reference);
+        buildSchema(lazy);
+        lazy.lazy();
+
+        ArgParser frozen;
+        buildSchema(frozen);
+        frozen.freeze(blob);
+        compiled.emplace(blob);
+    }
+
+    NaiveParser naive;
+    ArgParser reference;
+    ArgParser lazy;
+    std::string blob;
+    std::optional<CompiledSchema> compiled;
+};
+
+Schemas& schemas() {
+    static Schemas instance;
+
+    return instance;
+}
+
+bool isFlag(const NaiveArgument& argument) {
+    return argument.kind == NaiveKind::Flag;
+}
+
+template <typename Source>
+Snapshot capture(const std::optional<ParseErrorInfo>& error, const Source& source,
+                std::span<const std::string_view> positionals, ParseState state = ParseState::Complete) {
+    Snapshot snapshot;
+    snapshot.state = state;
+
+    if (error) {
+        snapshot.error = error->code;
+        snapshot.tokenIndex = error->tokenIndex;
+
+        return snapshot;
+    }
+
+    for (const auto& argument : schemaArguments()) {
+        const auto& name = argument.name();
+        snapshot.set.push_back(source.isSet(name));
+        snapshot.counts.push_back(source.count(name));
+
+        if (isFlag(argument)) {
+            snapshot.values.emplace_back();
+            snapshot.integers.emplace_back();
+            snapshot.ints.emplace_back();
+            snapshot.doubles.emplace_back();
+
+            continue;
+        }
+
+        snapshot.values.push_back(source.template getAll<std::string>(name));
+        snapshot.integers.push_back(source.template get<long long>(name));
+        snapshot.ints.push_back(source.template get<int>(name));
+        snapshot.doubles.push_back(source.template get<double>(name));
+    }
+
+    snapshot.positionals.assign(positionals.begin(), positionals.end());
+
+    return snapshot;
+}
+
+[[noreturn]] void fail(std::span<const std::string_view> tokens, std::string_view path, std::string_view what) {
+    std::cerr << "differential mismatch in " << path << ": " << what << "\ntokens:";
+
+    for (const auto token : tokens) {
+        std::cerr << " [" << token << "]";
+    }
+
+    std::cerr << std::endl;
+    std::abort();
+}
+
+// NaN only compares equal to NaN here, so "nan" parsed both ways is a match.
+bool sameDouble(const std::optional<double>& lhs, const std::optional<double>& rhs) {
+
+    if (lhs && rhs && std::isnan(*lhs)) {
+        return std::isnan(*rhs);
+    }
+
+    return lhs == rhs;
+}
+
+void compare(std::span<const std::string_view> tokens, std::string_view path,
+            const Snapshot& expected, const Snapshot& actual) {
+
+    if (expected.state != actual.state) {
+        fail(tokens, path, "parse state");
+    }
+
+    if (expected.error != actual.error) {
+        fail(tokens, path, "error code");
+    }
+
+    if (expected.tokenIndex != actual.tokenIndex) {
+        fail(tokens, path, "error token index");
+    }
+
+    for (std::size_t i = 0; i < expected.set.size(); ++i) {
+        const auto& name = schemaArguments()[i].name();
+
+        if (expected.set[i] != actual.set[i] || expected.counts[i] != actual.counts[i]) {
+            fail(tokens, path, "isSet/count of " + name);
+        }
+
+        if (expected.values[i] != actual.values[i]) {
+            fail(tokens, path, "values of " + name);
+        }
+
+        if (expected.integers[i] != actual.integers[i] || expected.ints[i] != actual.ints[i]) {
+            fail(tokens, path, "integer value of " + name);
+        }
+
+        if (!sameDouble(expected.doubles[i], actual.doubles[i])) {
+            fail(tokens, path, "double value of " + name);
+        }
+    }
+
+    if (expected.positionals != actual.positionals) {
+        fail(tokens, path, "positionals");
+    }
+}
+
+// parseBatch() reports the last value or the default per column, so only that is compared.
+void compareBatch(std::span<const std::string_view> tokens, const Snapshot& expected,
+                const ArgParser& parser) {
+    static InlineExecutor executor;
+    const CommandLine line{tokens};
+    const auto batch = parser.parseBatch(std::span<const CommandLine>(&line, 1), executor);
+
+    if (batch.failed(0) != expected.error.has_value()) {
+        fail(tokens, "parseBatch", "failure");
+    }
+
+    if (!expected.error) {
+        const auto state = expected.state == ParseState::HelpRequested    ? RowState::HelpRequested
+                            : expected.state == ParseState::VersionRequested ? RowState::VersionRequested
+                                                                            : RowState::Ok;
+
+        if (batch.state(0) != state) {
+            fail(tokens, "parseBatch", "row state");
+        }
+    }
+
+    if (expected.error) {
+
+        if (batch.errors().front().info.code != *expected.error) {
+            fail(tokens, "parseBatch", "error code");
+        }
+
+        return;
+    }
+
+    // Help and version rows keep the defaults, which the snapshot does not hold.
+    if (expected.state != ParseState::Complete) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < schemaArguments().size(); ++i) {
+        const auto& argument = schemaArguments()[i];
+        const auto column = batch.column(argument.name());
+        const auto value = batch.values(column)[0];
+
+        if (batch.counts(column)[0] != expected.counts[i]) {
+            fail(tokens, "parseBatch", "count of " + argument.name());
+        }
+
+        if (isFlag(argument)) {
+
+            if (value != (expected.set[i] ? "true" : "false")) {
+                fail(tokens, "parseBatch", "flag " + argument.name());
+            }
+
+            continue;
+        }
+
+        const auto& values = expected.values[i];
+
+        if (values.empty() ? !value.empty() : value != values.back()) {
+            fail(tokens, "parseBatch", "value of " + argument.name());
+        }
+    }
+}
+
+// findEquals() scans in 16-byte blocks and hands long tokens to memchr, so
+// every suffix of the token is checked to move the '=' and the end of the
+// text across block boundaries.
+void checkFindEquals(std::span<const std::string_view> tokens) {
+
+    for (const auto token : tokens) {
+
+        for (std::size_t start = 0; start <= token.size(); ++start) {
+            const std::string copy(token.substr(start));
+
+            if (findEquals(token.substr(start)) != copy.find('=')) {
+                fail(tokens, "findEquals", "position of '=' in [" + copy + "]");
+            }
+        }
+    }
+}
+
+}
+
+std::vector<std::string_view> splitInput(const std::uint8_t* data, std::size_t size) {
+    std::vector<std::string_view> tokens;
+    const std::string_view input(reinterpret_cast<const char*>(data), size);
+    std::size_t start = 0;
+
+    while (start <= input.size() && !input.empty()) {
+        auto end = input.find('\0', start);
+
+        if (end == std::string_view::npos) {
+            end = input.size();
+        }
+
+        tokens.push_back(input.substr(start, end - start));
+        start = end + 1;
+    }
+
+    return tokens;
+}
+
+void checkTokens(std::span<const std::string_view> tokens) {
+    auto& instance = schemas();
+    auto& reference = instance.reference;
+
+    checkFindEquals(tokens);
+
+    const std::vector<std::string> owned(tokens.begin(), tokens.end());
+    const auto expected = instance.naive.parse(owned);
+
+    reference.reset();
+    RangeTokenSource referenceSource(tokens.begin(), tokens.end());
+    const auto referenceError = reference.tryParse(referenceSource);
+    compare(tokens, "parser state", expected,
+            capture(referenceError, reference, reference.positionalViews(), reference.state()));
+
+    ParseResult result;
+    RangeTokenSource resultSource(tokens.begin(), tokens.end());
+    const auto resultError = reference.tryParse(resultSource, result);
+    compare(tokens, "ParseResult", expected, capture(resultError, result, result.positionalViews(), result.state()));
+
+    ParseResult lazyResult;
+    RangeTokenSource lazySource(tokens.begin(), tokens.end());
+    const auto lazyError = instance.lazy.tryParse(lazySource, lazyResult);
+    compare(tokens, "lazy", expected,
+            capture(lazyError, lazyResult, lazyResult.positionalViews(), lazyResult.state()));
+
+    compareBatch(tokens, expected, reference);
+
+    // CompiledSchema has no help or version handling.
+    if (expected.state != ParseState::Complete) {
+        return;
+    }
+
+    CompiledResult compiledResult;
+    RangeTokenSource compiledSource(tokens.begin(), tokens.end());
+    const auto compiledError = instance.compiled->tryParse(compiledSource, compiledResult);
+    compare(tokens, "CompiledSchema", expected,
+            capture(compiledError, compiledResult, compiledResult.positionalViews()));
+}
+
+}
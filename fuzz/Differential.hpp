@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace argparser::fuzz {
+
+// Tokens of a fuzz input: its bytes split at every '\0'.
+[[nodiscard]] std::vector<std::string_view> splitInput(const std::uint8_t* data, std::size_t size);
+
+// Parses tokens with NaiveParser, a separate owning-string implementation that
+// serves as the reference, and with the parser-state, ParseResult, lazy(),
+// parseBatch() and CompiledSchema paths over the same schema. Prints the first
+// difference in parse state, errors, values, counts, positionals or the values
+// read back as long long, int and double to stderr and aborts, so a fuzzer
+// records the input. Help and version requests are compared too, and print
+// nothing. findEquals() is also checked against std::string::find on every
+// suffix of every token.
+void checkTokens(std::span<const std::string_view> tokens);
+
+}
@@ -0,0 +1,149 @@
+#include "Differential.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Runs the differential check without libFuzzer, so it also builds with GCC:
+//
+//     argparser_differential [iterations] [seed]   random command lines
+//     argparser_differential file...               replays fuzzer inputs
+//
+// The fixed edge cases below run first either way.
+namespace {
+
+void check(std::initializer_list<std::string_view> tokens) {
+    const std::vector<std::string_view> line(tokens);
+    argparser::fuzz::checkTokens(line);
+}
+
+void checkEdgeCases() {
+    check({});
+    check({"-"});
+    check({"--"});
+    check({"---"});
+    check({"--="});
+    check({"--=value"});
+    check({"in", "--output="});
+    check({"in", "--output=", "--name="});
+    check({"in", "--output"});
+    check({"in", "-o"});
+    check({"in", "-x"});
+    check({"in", "--point", "1"});
+    check({"in", "--point=1"});
+    check({"in", "--point", "1", "2", "--point=3", "4"});
+    check({"in", "-vq", "-vvo", "file"});
+    check({"in", "-voutput"});
+    check({"in", "-v=1"});
+    check({"in", "--verbose=1"});
+    check({"in", "--verbose="});
+    check({"in", "-xq"});
+    check({"in", "-I", "a", "-Ib", "--include=c", "--include", "d"});
+    check({"in", "extra", "more", "-", "--level", "-"});
+    check({"--output", "--name", "in"});
+    check({"-o", "-v", "in"});
+    check({"in", "--unknown"});
+    check({"in", "-z"});
+    check({"in", "--outpu"});
+    check({"@file", "in"});
+    check({"", "in"});
+    check({"in", std::string_view("-\0v", 3)});
+    check({"-h"});
+    check({"in", "-v", "--help", "--unknown"});
+    check({"--version"});
+    check({"--output", "--version"});
+    check({"-vh"});
+    check({"in", "--level=+7", "--output=-7", "-n", "+-7"});
+    check({"in", "--level= 7", "--output=0x10", "-n", "7 "});
+    check({"in", "--level=2147483648", "--output=-9223372036854775809"});
+    check({"in", "--level=1e400", "--output=4e-320", "-n", "1e-400"});
+    check({"in", "--level=inf", "--output=-nan", "-n", "+.5"});
+    check({"in", "--output=0123456789abcdef0123456789abcdef=", "--name=0123456789abcdef="});
+    check({"in", "--0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef=1"});
+}
+
+// Tokens built from pieces of the schema's syntax, so most of them get past
+// the first lookup and reach the value and cluster handling. The numeric
+// pieces reach the conversions, and one token in eight is long enough for
+// findEquals() to scan whole blocks or hand over to memchr.
+std::string randomToken(std::mt19937& engine) {
+    static const std::vector<std::string_view> pieces = {
+        "-", "--", "=", "v", "q", "o", "n", "I", "x", "h", "verbose", "quiet", "output", "name",
+        "include", "point", "level", "version", "help", "in", "file", "1", "", " ", "@", "\xff",
+        "0", "7", "+", ".", "e", "0x", "inf", "nan", "2147483648", "9223372036854775807", "1e400",
+        "4e-320", "0123456789abcdef"};
+    std::uniform_int_distribution<std::size_t> length(1, 4);
+    std::uniform_int_distribution<std::size_t> longLength(5, 24);
+    std::uniform_int_distribution<std::size_t> piece(0, pieces.size() - 1);
+    std::string token;
+    auto count = engine() % 8 == 0 ? longLength(engine) : length(engine);
+
+    for (; count > 0; --count) {
+        token.append(pieces[piece(engine)]);
+    }
+
+    return token;
+}
+
+void checkRandom(std::uint64_t iterations, std::uint32_t seed) {
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<std::size_t> tokenCount(0, 8);
+    std::vector<std::string> tokens;
+    std::vector<std::string_view> views;
+
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        tokens.clear();
+
+        for (auto count = tokenCount(engine); count > 0; --count) {
+            tokens.push_back(randomToken(engine));
+        }
+
+        views.assign(tokens.begin(), tokens.end());
+        argparser::fuzz::checkTokens(views);
+    }
+}
+
+bool isNumber(std::string_view text) {
+    return !text.empty() && text.find_first_not_of("0123456789") == std::string_view::npos;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    checkEdgeCases();
+
+    if (argc > 1 && !isNumber(argv[1])) {
+
+        for (int i = 1; i < argc; ++i) {
+            std::ifstream file(argv[i], std::ios::binary);
+
+            if (!file) {
+                std::cerr << "cannot read " << argv[i] << "\n";
+
+                return 1;
+            }
+
+            const std::string input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            const auto tokens = argparser::fuzz::splitInput(reinterpret_cast<const std::uint8_t*>(input.data()),
+                                                            input.size());
+            argparser::fuzz::checkTokens(tokens);
+        }
+
+        std::cout << "replayed " << (argc - 1) << " inputs\n";
+
+        return 0;
+    }
+
+    const std::uint64_t iterations = argc > 1 ? std::stoull(argv[1]) : 100000;
+    const std::uint32_t seed = argc > 2 ? static_cast<std::uint32_t>(std::stoul(argv[2])) : 1;
+    checkRandom(iterations, seed);
+    std::cout << "checked " << iterations << " command lines, seed " << seed << "\n";
+
+    return 0;
+}
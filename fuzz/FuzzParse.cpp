@@ -0,0 +1,12 @@
+#include "Differential.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// libFuzzer entry point: the input's '\0'-separated parts are the command line.
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+    const auto tokens = argparser::fuzz::splitInput(data, size);
+    argparser::fuzz::checkTokens(tokens);
+
+    return 0;
+}
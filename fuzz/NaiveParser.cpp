@@ -0,0 +1,323 @@
+#include "NaiveParser.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
+namespace argparser::fuzz {
+
+namespace {
+
+constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+bool startsWithSpace(const std::string& text) {
+    const char first = text.front();
+
+    return first == ' ' || first == '\t' || first == '\n' || first == '\v' || first == '\f' || first == '\r';
+}
+
+// strtoll and strtod take any sign; the library takes one '-' or one '+' that
+// is not followed by '-'. Both reject what is left over, so only "+-..." needs
+// catching here.
+bool acceptsSign(const std::string& text) {
+    return !(text.size() >= 2 && text[0] == '+' && text[1] == '-');
+}
+
+struct State {
+    explicit State(std::size_t size) : given(size), counts(size, 0) {}
+
+    std::vector<std::vector<std::string>> given;
+    std::vector<std::size_t> counts;
+    std::vector<std::string> positionals;
+};
+
+struct Run {
+    Run(const std::vector<NaiveArgument>& schema, const std::vector<std::string>& line)
+        : arguments(schema), tokens(line), state(schema.size()) {}
+
+    const std::vector<NaiveArgument>& arguments;
+    const std::vector<std::string>& tokens;
+    State state;
+    std::size_t next = 0;
+    std::optional<ParseErrorCode> error;
+    std::size_t errorIndex = npos;
+
+    bool fail(ParseErrorCode code, std::size_t index) {
+        error = code;
+        errorIndex = index;
+
+        return false;
+    }
+
+    void add(std::size_t argument, const std::string& value) {
+        auto& given = state.given[argument];
+
+        if (!arguments[argument].append && arguments[argument].nargs == 1) {
+            given.clear();
+        }
+        given.push_back(value);
+        ++state.counts[argument];
+    }
+
+    // The first value is already read; the other nargs - 1 are the tokens that
+    // follow. A missing one is reported at the last token consumed.
+    bool store(std::size_t argument, const std::string& first, std::size_t at) {
+        add(argument, first);
+
+        for (std::size_t i = 1; i < arguments[argument].nargs; ++i) {
+
+            if (next == tokens.size()) {
+                return fail(ParseErrorCode::MissingValue, at);
+            }
+            at = next;
+            add(argument, tokens[next++]);
+        }
+
+        return true;
+    }
+
+    // The option's value comes from the rest of its own token or the next one.
+    bool takeValue(std::size_t argument, std::size_t at, bool inToken, const std::string& rest) {
+
+        if (inToken) {
+            return store(argument, rest, at);
+        }
+
+        if (next == tokens.size()) {
+            return fail(ParseErrorCode::MissingValue, at);
+        }
+        at = next;
+
+        return store(argument, tokens[next++], at);
+    }
+};
+
+}
+
+NaiveParser::NaiveParser(std::vector<NaiveArgument> arguments, bool version)
+    : m_arguments(std::move(arguments)), m_version(version) {}
+
+std::size_t NaiveParser::find(const std::string& name) const {
+
+    if (name.empty()) {
+        return npos;
+    }
+
+    for (std::size_t i = 0; i < m_arguments.size(); ++i) {
+
+        if (m_arguments[i].shortName == name || m_arguments[i].longName == name) {
+            return i;
+        }
+    }
+
+    return npos;
+}
+
+std::size_t NaiveParser::findShort(char name) const {
+
+    for (std::size_t i = 0; i < m_arguments.size(); ++i) {
+        const auto& shortName = m_arguments[i].shortName;
+
+        if (m_arguments[i].kind != NaiveKind::Positional && shortName.size() == 1 && shortName[0] == name) {
+            return i;
+        }
+    }
+
+    return npos;
+}
+
+Snapshot NaiveParser::parse(const std::vector<std::string>& tokens) const {
+    Run run(m_arguments, tokens);
+    Snapshot snapshot;
+
+    auto failed = [&snapshot, &run] {
+        snapshot.error = run.error;
+        snapshot.tokenIndex = run.errorIndex;
+
+        return snapshot;
+    };
+
+    while (run.next < tokens.size()) {
+        const std::size_t at = run.next;
+        const std::string& token = tokens[run.next++];
+
+        if (token == "--help" || token == "-h") {
+            snapshot.state = ParseState::HelpRequested;
+
+            break;
+        }
+
+        if (m_version && token == "--version") {
+            snapshot.state = ParseState::VersionRequested;
+
+            break;
+        }
+
+        if (token.size() < 2 || token[0] != '-') {
+            run.state.positionals.push_back(token);
+
+            continue;
+        }
+
+        if (token[1] == '-') {
+            const std::string body = token.substr(2);
+            const auto equals = body.find('=');
+            const std::string key = body.substr(0, equals);
+            const auto argument = find(key);
+
+            if (argument == npos) {
+                run.fail(ParseErrorCode::UnknownArgument, at);
+
+                return failed();
+            }
+
+            if (m_arguments[argument].kind == NaiveKind::Flag) {
+
+                if (equals != std::string::npos) {
+                    run.fail(ParseErrorCode::UnexpectedValue, at);
+
+                    return failed();
+                }
+                ++run.state.counts[argument];
+
+                continue;
+            }
+
+            const std::string value = equals == std::string::npos ? std::string() : body.substr(equals + 1);
+
+            if (!run.takeValue(argument, at, equals != std::string::npos, value)) {
+                return failed();
+            }
+
+            continue;
+        }
+
+        for (std::size_t i = 1; i < token.size(); ++i) {
+            const auto argument = findShort(token[i]);
+
+            if (argument == npos) {
+                run.fail(ParseErrorCode::UnknownArgument, at);
+
+                return failed();
+            }
+
+            if (m_arguments[argument].kind == NaiveKind::Flag) {
+                ++run.state.counts[argument];
+
+                continue;
+            }
+
+            if (!run.takeValue(argument, at, i + 1 < token.size(), token.substr(i + 1))) {
+                return failed();
+            }
+
+            break;
+        }
+    }
+
+    // Help and version stop before positionals are assigned and required arguments checked.
+    if (snapshot.state == ParseState::Complete) {
+        std::size_t positional = 0;
+
+        for (std::size_t i = 0; i < m_arguments.size() && positional < run.state.positionals.size(); ++i) {
+
+            if (m_arguments[i].kind == NaiveKind::Positional) {
+                run.add(i, run.state.positionals[positional++]);
+            }
+        }
+
+        for (std::size_t i = 0; i < m_arguments.size(); ++i) {
+
+            if (m_arguments[i].required && run.state.counts[i] == 0) {
+                run.fail(ParseErrorCode::MissingRequired, npos);
+
+                return failed();
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < m_arguments.size(); ++i) {
+        const auto& argument = m_arguments[i];
+        const auto& given = run.state.given[i];
+        const bool isSet = run.state.counts[i] != 0;
+        snapshot.set.push_back(isSet);
+        snapshot.counts.push_back(run.state.counts[i]);
+
+        // Flags carry no values, and neither does an option that was not given and has no default.
+        if (argument.kind == NaiveKind::Flag || (!isSet && argument.defaultValue.empty())) {
+            snapshot.values.emplace_back();
+            snapshot.integers.emplace_back();
+            snapshot.ints.emplace_back();
+            snapshot.doubles.emplace_back();
+
+            continue;
+        }
+
+        snapshot.values.push_back(isSet ? given : std::vector<std::string>{argument.defaultValue});
+
+        const std::string& current = isSet ? given.back() : argument.defaultValue;
+        snapshot.integers.push_back(naiveInteger(current));
+        snapshot.ints.push_back(naiveInt(current));
+        snapshot.doubles.push_back(naiveDouble(current));
+    }
+
+    snapshot.positionals = std::move(run.state.positionals);
+
+    return snapshot;
+}
+
+std::optional<long long> naiveInteger(const std::string& text) {
+
+    if (text.empty() || startsWithSpace(text) || !acceptsSign(text)) {
+        return std::nullopt;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    const long long value = std::strtoll(text.c_str(), &end, 10);
+
+    if (end != text.c_str() + text.size() || errno == ERANGE) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+std::optional<int> naiveInt(const std::string& text) {
+    const auto value = naiveInteger(text);
+
+    if (!value || *value < INT_MIN || *value > INT_MAX) {
+        return std::nullopt;
+    }
+
+    return static_cast<int>(*value);
+}
+
+std::optional<double> naiveDouble(const std::string& text) {
+
+    if (text.empty() || startsWithSpace(text) || !acceptsSign(text)) {
+        return std::nullopt;
+    }
+
+    // strtod reads hex floats; the library only takes decimal ones.
+    const std::size_t digits = text[0] == '+' || text[0] == '-' ? 1 : 0;
+
+    if (text.size() >= digits + 2 && text[digits] == '0' && (text[digits + 1] == 'x' || text[digits + 1] == 'X')) {
+        return std::nullopt;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    const double value = std::strtod(text.c_str(), &end);
+
+    // ERANGE also flags denormals, which the library accepts.
+    if (end != text.c_str() + text.size() || (errno == ERANGE && (std::isinf(value) || value == 0))) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ParseErrorInfo.hpp"
+#include "ParseResult.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace argparser::fuzz {
+
+// A second, deliberately plain implementation of the command line rules the
+// differential check holds the library to. It owns every string, splits long
+// options with std::string::find('=') and converts numbers with strtoll and
+// strtod, so it shares no code with the tokenizer, the argument table or
+// Converter.
+
+enum class NaiveKind {
+    Flag,
+    Option,
+    Positional
+};
+
+struct NaiveArgument {
+    NaiveKind kind = NaiveKind::Option;
+    std::string shortName;
+    // The positional's name for positionals.
+    std::string longName;
+    std::string defaultValue;
+    bool append = false;
+    std::size_t nargs = 1;
+    bool required = false;
+
+    // The name the checks look the argument up by.
+    [[nodiscard]] const std::string& name() const { return longName.empty() ? shortName : longName; }
+};
+
+// What a parse leaves behind, in argument order. Error snapshots hold only the
+// error; the typed values are empty for flags.
+struct Snapshot {
+    ParseState state = ParseState::Complete;
+    std::optional<ParseErrorCode> error;
+    std::size_t tokenIndex = ParseErrorInfo::npos;
+    std::vector<bool> set;
+    std::vector<std::size_t> counts;
+    std::vector<std::vector<std::string>> values;
+    std::vector<std::optional<long long>> integers;
+    std::vector<std::optional<int>> ints;
+    std::vector<std::optional<double>> doubles;
+    std::vector<std::string> positionals;
+};
+
+class NaiveParser {
+public:
+    // version: whether "--version" is a version request, as it is for a parser
+    // with a version and without an argument named "version".
+    NaiveParser(std::vector<NaiveArgument> arguments, bool version);
+
+    [[nodiscard]] const std::vector<NaiveArgument>& arguments() const { return m_arguments; }
+
+    [[nodiscard]] Snapshot parse(const std::vector<std::string>& tokens) const;
+
+private:
+    std::vector<NaiveArgument> m_arguments;
+    bool m_version;
+
+    [[nodiscard]] std::size_t find(const std::string& name) const;
+    [[nodiscard]] std::size_t findShort(char name) const;
+};
+
+// Whole-string conversions with the library's rules: an optional sign, where
+// '+' must be followed by something other than '-', no surrounding whitespace,
+// no hex, and doubles that neither overflow nor underflow to zero.
+[[nodiscard]] std::optional<long long> naiveInteger(const std::string& text);
+[[nodiscard]] std::optional<int> naiveInt(const std::string& text);
+[[nodiscard]] std::optional<double> naiveDouble(const std::string& text);
+
+}
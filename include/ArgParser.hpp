@@ -1,23 +1,44 @@
 #pragma once
 
 #include "Argument.hpp"
+#include "BatchParse.hpp"
+#include "CompiledSchema.hpp"
+#include "ConfigReader.hpp"
 #include "Exceptions.hpp"
+#include "MappedFile.hpp"
+#include "OutputSink.hpp"
+#include "ParseErrorInfo.hpp"
+#include "ParseObserver.hpp"
+#include "ParseResult.hpp"
+#include "StringPool.hpp"
+#include "TokenSource.hpp"
+#include "Tokenizer.hpp"
 
+#include <deque>
+#include <functional>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
 #include <vector>
 #include <unordered_map>
 #include <string>
 #include <string_view>
 #include <optional>
-#include <sstream>
 
 namespace argparser {
 
 class ArgParser {
 public:
-    
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    using SubcommandFactory = std::function<void(ArgParser&)>;
+
+    // Every argument, name, description, stored value and lookup node is
+    // allocated from the given resource, which must outlive the parser. Names
+    // and texts are interned into one StringPool per parser.
     explicit ArgParser(std::string_view programName = "",
-                        std::string_view description = "");
+                        std::string_view description = "",
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     
     ~ArgParser() = default;
 
@@ -36,11 +57,57 @@ public:
     Argument& addPositional(std::string_view name, std::string_view description,
                             bool required = false);
 
+    // Registers a subcommand without building it: factory fills in the
+    // sub-parser's schema the first time name shows up as a positional token.
+    // The tokens after the name are parsed by the sub-parser from the same
+    // source, so they are never copied.
+    ArgParser& addSubcommand(std::string_view name, SubcommandFactory factory,
+                            std::string_view description = "");
+
+    // Name of the subcommand chosen by the last parse into the parser, or empty.
+    [[nodiscard]] std::string_view subcommand() const noexcept { return m_selectedSubcommand; }
+    // The sub-parser holding the subcommand's values; nullptr until its name was parsed.
+    [[nodiscard]] const ArgParser* subcommandParser(std::string_view name) const;
+
+    // Option values and positionals are kept as views into argv, which must
+    // outlive the parser. Use parsePositionalOption() for transient tokens.
     void parseOptions(int argc, char* argv[]);
     void parsePositionalOption(const std::vector<std::string>& args);
 
+    // Same as parseOptions, but reports failures instead of throwing them.
+    [[nodiscard]] std::optional<ParseErrorInfo> tryParse(int argc, char* argv[]);
+    [[nodiscard]] std::optional<ParseErrorInfo> tryParse(TokenSource& source);
+
+    // Parse into a separate result and leave the parser untouched, so one
+    // schema can serve any number of command lines. The result is cleared first.
+    // These overloads only read the schema: once it is fully built, any number
+    // of threads may call them at once, each with its own ParseResult.
+    void parseOptions(int argc, char* argv[], ParseResult& result) const;
+    [[nodiscard]] std::optional<ParseErrorInfo> tryParse(int argc, char* argv[], ParseResult& result) const;
+    [[nodiscard]] std::optional<ParseErrorInfo> tryParse(TokenSource& source, ParseResult& result) const;
+
+    // Parses every command line against the schema and lays the values out in
+    // columns. The rows are split over the executor's tasks; each task parses
+    // into a slab of its own and writes a disjoint set of rows, so nothing is
+    // shared between them. Besides the given tokens only the values from
+    // loadConfig() apply; environment fallbacks and response files do not, so
+    // a bound variable never decides a row. Validators and the positional
+    // sink may be called concurrently. Throws ArgumentError if an argument is
+    // bound, since every row would write to the same storage.
+    void parseBatch(std::span<const CommandLine> lines, Executor& executor, BatchResult& result) const;
+    [[nodiscard]] BatchResult parseBatch(std::span<const CommandLine> lines, Executor& executor) const;
+
+    // Forgets the values stored by previous parses; the schema is kept.
+    void reset();
+
+    // Where the last parse into the parser stopped; see ParseState.
+    [[nodiscard]] ParseState state() const noexcept { return m_state; }
+
     template <typename T>
     [[nodiscard]] std::optional<T> get(std::string_view name) const;
+    // Every value of an append() or nargs() option, in command line order.
+    template <typename T>
+    [[nodiscard]] std::vector<T> getAll(std::string_view name) const;
 
     [[nodiscard]] std::string getString(std::string_view name) const;
     [[nodiscard]] int getInt(std::string_view name) const;
@@ -48,36 +115,250 @@ public:
     [[nodiscard]] bool getBool (std::string_view name) const;
 
     [[nodiscard]] bool isSet(std::string_view name) const;
+    // Number of times the argument was given, e.g. 3 for -vvv.
+    [[nodiscard]] std::size_t count(std::string_view name) const;
 
-    [[nodiscard]] const std::vector<std::string>& positionalArguments() const noexcept;
+    [[nodiscard]] const std::vector<std::string>& positionalArguments() const;
+    [[nodiscard]] std::span<const std::string_view> positionalViews() const noexcept;
 
+    // Rendered once and cached until the schema or the parser's texts change.
     [[nodiscard]] std::string help() const;
+    // Appends the help text to out, without going through the cache.
+    void formatHelp(std::string& out) const;
+    // Writes the cached help text and a newline to the output sink in one call,
+    // outside the cache's lock, so the sink may call help() again.
     void printHelp() const;
 
+    // Sizes the schema storage for about arguments more arguments whose names
+    // and texts add up to textBytes, so building it allocates once per array.
+    ArgParser& reserve(std::size_t arguments, std::size_t textBytes = 0);
+
     ArgParser& programName(std::string_view name);
     ArgParser& description(std::string_view desc);
     ArgParser& version(std::string_view version);
 
+    // -h and --help, and --version once a version is set and no argument is
+    // named "version", print to this sink. nullptr restores standardOutput().
+    // The sink must outlive the parser; parses call it on their own thread.
+    ArgParser& output(OutputSink* sink) noexcept;
+    // Enabled by default: after printing, -h, --help and --version end the
+    // process with std::exit(0). Disabled, the parse stops at the token and
+    // reports ParseState::HelpRequested or VersionRequested. Subcommands
+    // inherit this and the output sink when they are built.
+    ArgParser& exitOnHelp(bool enabled = true);
+
+    // Reads "long-name = value" lines from an INI-style file (see ConfigReader)
+    // and uses them for the options a parse leaves unset, so the precedence is
+    // command line > environment > config file > default. A flag takes a bool
+    // word and is set by a true one ("true", "1", "yes", "on"). Repeating a
+    // key gives an append() option several values; a later file replaces the
+    // keys it names. The file stays mapped for the parser's lifetime. Help
+    // shows the loaded value next to the declared default, or the bound
+    // variable's value when it is set and outranks the file. Throws ArgumentError if the file
+    // cannot be read, has a malformed line, names an unknown long option or
+    // gives a flag a value that is not a bool word.
+    ArgParser& loadConfig(const std::string& path);
+
+    // When enabled, a token of the form @path is replaced by the tokens read
+    // from that file. The file is memory-mapped and stays mapped until reset()
+    // (or until the ParseResult is reused), since parsed values point into it.
+    ArgParser& responseFiles(bool enabled = true);
+
+    // Positionals left over once every declared positional argument has its
+    // value are handed to the sink as soon as they are parsed instead of being
+    // collected. The sink runs on the parsing thread, also for the ParseResult
+    // overloads, and the views it receives point into the parsed tokens.
+    ArgParser& onPositional(std::function<void(std::string_view)> sink);
+
+    // Accept any unambiguous prefix of a long name, e.g. --verb for --verbose.
+    ArgParser& allowAbbreviations(bool enabled = true);
+
+    // Stores values unchecked while the tokens are read and runs every
+    // validator and built-in check in one batch afterwards. Errors then carry
+    // no token index.
+    ArgParser& deferValidation(bool enabled = true);
+
+    // Parses into a ParseResult by only recording where each argument's values
+    // are: validators, checks and environment fallbacks run the first time the
+    // argument is read from the result, once per argument, and a value that
+    // fails them throws ValidationError from that read. Unknown options,
+    // missing values and missing required arguments still fail the parse.
+    // Applies to the ParseResult overloads; bound arguments are not supported.
+    ArgParser& lazy(bool enabled = true);
+
+    // Reports phase timings and validator calls of every parse, including the
+    // sub-parser's part of it. Has no effect unless the library is built with
+    // ARGPARSER_INSTRUMENTATION; nullptr detaches the observer.
+    ArgParser& observer(ParseObserver* observer) noexcept;
+
+    // Sorts the long-name index behind abbreviations and suggestions and
+    // compiles pattern() checks. Parsing
+    // through the parser itself does this on demand; call it once the schema
+    // is complete before sharing the parser between threads.
+    void freeze();
+    // Also writes the schema to blob in the binary format CompiledSchema
+    // loads, replacing its contents. Throws ArgumentError if an argument has a
+    // validator, checks, a binding or an environment variable, or if there
+    // are subcommands, since none of them can be stored.
+    void freeze(std::string& blob);
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return allocator_type(m_resource); }
+
 private:
-    std::string m_programName;
-    std::string m_description;
-    std::string m_version;
+    template <typename T>
+    struct ResourceDeleter {
+        std::pmr::memory_resource* resource;
+
+        void operator()(T* ptr) const {
+            allocator_type(resource).delete_object(ptr);
+        }
+    };
+
+    using ArgumentPtr = std::unique_ptr<Argument, ResourceDeleter<Argument>>;
+
+    struct Subcommand {
+        Subcommand(std::string_view name, std::string_view description, SubcommandFactory factory,
+                    std::pmr::memory_resource* resource)
+            : name(name, resource), description(description, resource), factory(std::move(factory)) {}
+
+        std::pmr::string name;
+        std::pmr::string description;
+        SubcommandFactory factory;
+        // The first parse to reach the name builds the parser, even from the const overloads.
+        std::once_flag built;
+        std::unique_ptr<ArgParser, ResourceDeleter<ArgParser>> parser;
+    };
+
+    using SubcommandPtr = std::unique_ptr<Subcommand, ResourceDeleter<Subcommand>>;
+
+    struct ConfigValue {
+        std::uint32_t index;
+        std::string_view key;
+        std::string_view value;
+    };
+
+    struct HelpCache {
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
+        explicit HelpCache(const allocator_type& alloc) : text(alloc), environment(alloc) {}
 
-    std::vector<std::unique_ptr<Argument>> m_arguments;
-    std::unordered_map<std::string, Argument*> m_argMap;
-    std::vector<std::string> m_positionalValues;
+        std::mutex mutex;
+        std::pmr::string text;
+        // The bound variables the text was built with; see cachedHelp().
+        std::pmr::string environment;
+        std::uint64_t revision = 0;
+        bool valid = false;
+    };
+
+    // A pointer rather than an allocator: polymorphic_allocator cannot be
+    // assigned, which would delete the parser's move assignment.
+    std::pmr::memory_resource* m_resource;
+    // Heap-allocated so the Arguments' back-pointers survive moving the parser.
+    std::unique_ptr<ArgumentTable, ResourceDeleter<ArgumentTable>> m_table;
+    std::unique_ptr<HelpCache, ResourceDeleter<HelpCache>> m_helpCache;
+    // Heap-allocated like the table, since the Arguments and texts point into it.
+    std::unique_ptr<StringPool, ResourceDeleter<StringPool>> m_strings;
+    std::string_view m_programName;
+    std::string_view m_description;
+    std::string_view m_version;
+
+    std::pmr::vector<ArgumentPtr> m_arguments;
+    // Argument index for every interned name id; npos for ids that are not names.
+    std::pmr::vector<std::uint32_t> m_argumentsById;
+    std::pmr::vector<std::string_view> m_positionalViews;
+    mutable std::vector<std::string> m_positionalValues;
+    using TokenStore = std::pmr::deque<std::pmr::string>;
+    // Heap-allocated as well: a move assignment between parsers on different
+    // resources would copy the strings that stored values point into.
+    std::unique_ptr<TokenStore, ResourceDeleter<TokenStore>> m_ownedTokens;
+    std::pmr::vector<MappedFile> m_mappedFiles;
+    // Unlike the response files, config files stay mapped across reset().
+    std::pmr::vector<MappedFile> m_configFiles;
+    // Values from loadConfig(), grouped by argument index and in file order within a group.
+    std::pmr::vector<ConfigValue> m_config;
+    bool m_responseFiles = false;
+    bool m_abbreviations = false;
+    std::function<void(std::string_view)> m_positionalSink;
+    std::pmr::vector<SubcommandPtr> m_subcommands;
+    std::pmr::unordered_map<std::string_view, Subcommand*> m_subcommandMap;
+    std::string_view m_selectedSubcommand;
+    ParseObserver* m_observer = nullptr;
+    bool m_deferValidation = false;
+    bool m_lazy = false;
+    bool m_exitOnHelp = true;
+    OutputSink* m_output = nullptr;
+    ParseState m_state = ParseState::Complete;
 
     /*void parseArgument(const std::string& arg, std::vector<std::string>::const_iterator& it,
                         const std::vector<std::string>::const_iterator& end);*/
-    void parseShortOption(const std::string& arg, std::vector<std::string>::const_iterator& it,
-                        const std::vector<std::string>::const_iterator& end);
-    void parseLongOption(const std::string& arg, std::vector<std::string>::const_iterator& it,
-                        const std::vector<std::string>::const_iterator& end);
-    void validateRequiredArgument() const;
+    class TokenCursor;
+    class ParseProbe;
+    class ArgumentStore;
+    class ResultStore;
+
+    friend class ParseResult;
+    friend class BatchResult;
+    friend class CompiledSchema;
+
+    template <typename Store>
+    [[nodiscard]] std::optional<ParseErrorInfo> parseTokens(TokenCursor& cursor, Store& store) const;
+    template <typename Store>
+    [[nodiscard]] std::optional<ParseErrorInfo> parseShortOption(std::string_view arg, TokenCursor& cursor,
+                                                                Store& store) const;
+    template <typename Store>
+    [[nodiscard]] std::optional<ParseErrorInfo> parseLongOption(std::string_view arg, const Token& token,
+                                                                TokenCursor& cursor, Store& store) const;
+    template <typename Store>
+    [[nodiscard]] std::optional<ParseErrorInfo> storeValues(std::string_view arg, Argument& argument,
+                                                            std::string_view value, TokenCursor& cursor,
+                                                            Store& store) const;
+    template <typename Store>
+    [[nodiscard]] std::optional<ParseErrorInfo> stopForHelp(Store& store, ParseState state) const;
+    template <typename Store>
+    [[nodiscard]] std::optional<ParseErrorInfo> applyEnvironment(Store& store) const;
+    template <typename Store>
+    [[nodiscard]] std::optional<ParseErrorInfo> applyConfig(Store& store) const;
+    [[nodiscard]] std::span<const ConfigValue> configValues(std::size_t index) const noexcept;
+    void prepareResult(ParseResult& result) const;
+    [[nodiscard]] std::optional<ParseErrorInfo> parseBatchRow(const CommandLine& line, std::size_t row,
+                                                                ParseResult& slab, BatchResult& out) const;
+    ArgParser& buildSubcommand(Subcommand& subcommand) const;
+    template <typename Store>
+    [[nodiscard]] std::optional<ParseErrorInfo> validateRequiredArgument(Store& store) const;
+    // The checks and environment fallback a lazy parse skipped, for one argument.
+    void resolveLazy(const ParseResult& result, const Argument& argument) const;
+    [[nodiscard]] bool applyLazyFallback(const ParseResult& result, const Argument& argument) const;
+    [[nodiscard]] bool applyLazyEnvironment(const ParseResult& result, const Argument& argument) const;
+    [[nodiscard]] bool applyLazyConfig(const ParseResult& result, const Argument& argument) const;
+    // True when the environment set the flag argument, or left it unset with a false word.
+    [[nodiscard]] bool environmentDecides(const Argument& argument) const;
+    // The value of the variable bound to argument, or nullptr when it is unset or unbound.
+    [[nodiscard]] const char* environmentValue(const Argument& argument) const;
+    template <typename Store>
+    [[nodiscard]] std::optional<ParseErrorInfo> validateDeferred(Store& store) const;
+
+    template <typename... Args>
+    Argument& emplaceArgument(Args&&... args);
+    void mapName(std::string_view name, Argument* arg);
+    void mapShortName(std::string_view name, Argument* arg);
+    void mapLongName(std::string_view name, Argument* arg);
 
     [[nodiscard]] Argument* findArgument(std::string_view name) const;
-    [[nodiscard]] std::string formatUsage() const;
-    [[nodiscard]] std::string formatArguments() const;
+    [[nodiscard]] OutputSink& sink() const noexcept { return m_output ? *m_output : standardOutput(); }
+    // Caller holds the help cache's mutex. Ends with the newline printHelp() writes.
+    [[nodiscard]] std::string_view cachedHelp() const;
+    void printVersion() const;
+    // Shared by formatHelp() and the cache, which keeps its text in the parser's resource.
+    template <typename String>
+    void appendHelp(String& out) const;
+    template <typename String>
+    void formatUsage(String& out) const;
+    template <typename String>
+    void formatArguments(String& out) const;
+    template <typename String>
+    void appendValueSources(String& out, const Argument& arg) const;
+    template <typename String>
+    void formatSubcommands(String& out) const;
 };
 
 template<typename T>
@@ -92,4 +373,11 @@ std::optional<T> ArgParser::get(std::string_view name) const {
     return arg->get<T>();
 } 
 
+template<typename T>
+std::vector<T> ArgParser::getAll(std::string_view name) const {
+    auto* arg = findArgument(name);
+
+    return arg ? arg->getAll<T>() : std::vector<T>{};
+}
+
 }
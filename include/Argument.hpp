@@ -1,59 +1,200 @@
 #pragma once 
 
+#include "ArgumentTable.hpp"
+#include "Converter.hpp"
+#include "Exceptions.hpp"
+#include "StringPool.hpp"
+#include "ValueChecks.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
 #include <string>
 #include <string_view>
 #include <optional>
 #include <variant>
 #include <vector>
 #include <functional>
+#include <initializer_list>
 #include <algorithm>
 #include <cctype>
+#include <memory_resource>
 
 
 namespace argparser {
     
-enum class ArgumentType {
-    Flag,
-    Option,
-    Positional
+// Parse-time state of one argument: whether it was set, its raw value (owned or
+// borrowed from the tokens) and the cached results of typed reads, one per type.
+// Every value given is also listed in values(); owned repeated values share
+// one pooled buffer, so collecting them costs no allocation per element.
+class ArgumentValue {
+public:
+    using ValueType = std::variant<std::string, int, double, bool>;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    ArgumentValue() = default;
+    explicit ArgumentValue(const allocator_type& alloc) : m_ownedValue(alloc), m_values(alloc), m_pool(alloc) {}
+    ArgumentValue(const ArgumentValue& other, const allocator_type& alloc);
+    ArgumentValue(ArgumentValue&& other, const allocator_type& alloc);
+    ArgumentValue(const ArgumentValue& other);
+    ArgumentValue(ArgumentValue&& other) noexcept;
+    ArgumentValue& operator=(const ArgumentValue& other);
+    ArgumentValue& operator=(ArgumentValue&& other) noexcept;
+
+    [[nodiscard]] bool isSet() const noexcept { return m_isSet; }
+    // How many times the argument was given during the current parse.
+    [[nodiscard]] std::size_t count() const noexcept { return m_count; }
+
+    [[nodiscard]] std::string_view value() const noexcept {
+        return m_ownsValue ? std::string_view(m_ownedValue) : m_view;
+    }
+
+    [[nodiscard]] std::span<const std::string_view> values() const noexcept { return m_values; }
+
+    // assign() replaces the value; append() adds one more and keeps the rest.
+    void assign(std::string_view value, bool owned);
+    void append(std::string_view value, bool owned);
+    void setFlag(bool value) noexcept;
+    void invalidate() const noexcept;
+    // Forgets the value but keeps the owned buffer's capacity for reuse.
+    void clear() noexcept;
+
+    template<typename T>
+    [[nodiscard]] std::optional<T> get(ArgumentType type, std::string_view defaultValue) const;
+
+    template<typename T>
+    [[nodiscard]] std::vector<T> getAll(std::string_view defaultValue) const;
+
+private:
+    using BufferRanges = std::array<std::string_view, 2>;
+
+    std::pmr::string m_ownedValue;
+    std::string_view m_view;
+    std::pmr::vector<std::string_view> m_values;
+    std::pmr::string m_pool;
+    bool m_isSet = false;
+    bool m_ownsValue = false;
+    std::uint32_t m_count = 0;
+
+    // Result of the first int, double or bool read of the value, cleared
+    // whenever it changes. The first reader to claim the slot fills it and
+    // publishes it with a release store, so concurrent reads of a finished
+    // result are race-free; readers that lose the claim convert on their own.
+    template<typename T>
+    class TypedSlot {
+    public:
+        TypedSlot() = default;
+        TypedSlot(const TypedSlot& other) noexcept { *this = other; }
+        TypedSlot& operator=(const TypedSlot& other) noexcept;
+
+        template<typename Convert>
+        [[nodiscard]] std::optional<T> get(Convert&& convert) const;
+        void reset() const noexcept { m_state.store(Empty, std::memory_order_relaxed); }
+
+    private:
+        enum : std::uint8_t { Empty, Filling, Valid, Invalid };
+
+        mutable std::atomic<std::uint8_t> m_state = Empty;
+        mutable T m_value{};
+    };
+
+    TypedSlot<int> m_int;
+    TypedSlot<double> m_double;
+    TypedSlot<bool> m_bool;
+
+    template<typename T>
+    [[nodiscard]] static std::optional<T> convert(std::string_view value);
+
+    template<typename T>
+    [[nodiscard]] const TypedSlot<T>& typedSlot() const noexcept;
+
+    [[nodiscard]] BufferRanges buffers() const noexcept { return {m_ownedValue, m_pool}; }
+    // Points views that referred into another value's buffers at ours.
+    void rebaseViews(const BufferRanges& from) noexcept;
 };
 
 class Argument {
 public:
-    using ValueType = std::variant<std::string, int, double, bool>;
+    using ValueType = ArgumentValue::ValueType;
     using ValidatorFunction = std::function<bool(const std::string&)>;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
 
-    Argument(std::string_view shortName, std::string_view longName, 
-            std::string_view description);
+    // Names and texts are interned into strings, which must outlive the
+    // argument; ArgParser passes its own pool.
+    Argument(StringPool& strings, std::string_view shortName, std::string_view longName,
+            std::string_view description, const allocator_type& alloc = {});
     
-    Argument(std::string_view shortName, std::string_view longName, 
-            std::string_view description, std::string_view defaultValue);
+    Argument(StringPool& strings, std::string_view shortName, std::string_view longName,
+            std::string_view description, std::string_view defaultValue,
+            const allocator_type& alloc = {});
     
-    explicit Argument(std::string_view name, std::string_view description,
-                        bool required = false);
+    Argument(StringPool& strings, std::string_view name, std::string_view description,
+            bool required = false, const allocator_type& alloc = {});
     
     Argument& required(bool isRequired = true);
     Argument& defaultValue(std::string_view value);
     Argument& help(std::string_view description);
     Argument& validator(ValidatorFunction func);
+    // Built-in checks, run on the value itself and before validator().
+    Argument& range(double min, double max);
+    Argument& choices(std::initializer_list<std::string_view> values);
+    Argument& length(std::size_t min, std::size_t max);
+    // ECMAScript regex the whole value must match, compiled once by ArgParser::freeze().
+    Argument& pattern(std::string_view regex);
+    // Opt-in, since every value costs a filesystem lookup.
+    Argument& pathExists(bool enabled = true);
+    // Falls back to this environment variable when the option is not given on
+    // the command line; precedence is command line > environment > default.
+    // Throws ArgumentError if another argument is already bound to name.
+    Argument& env(std::string_view name);
+    // Keep every occurrence instead of the last one (-I a -I b).
+    Argument& append(bool enabled = true);
+    // Each occurrence takes count values (--point 1 2); implies append().
+    Argument& nargs(std::size_t count);
+    // Every value stored is also converted into target, so reading it back
+    // needs no lookup by name. When the argument is not given, the default
+    // (false for a flag) is written instead. A value that does not convert
+    // fails the parse. Flags bind to bool; target must outlive the parser.
+    template<typename T>
+    Argument& bind(T& target);
     
     template<typename T>
     Argument& defaultValue(T value);
 
-    [[nodiscard]] const std::string& shortName() const noexcept { return m_shortName; }
-    [[nodiscard]] const std::string& longName() const noexcept { return m_longName; }
-    [[nodiscard]] const std::string& name() const noexcept { return m_name; }
-    [[nodiscard]] const std::string& description() const noexcept { return m_description; }
-    [[nodiscard]] const std::string& defaultValue() const noexcept { return m_defaultValue; }
+    [[nodiscard]] std::string_view shortName() const noexcept { return m_shortName; }
+    [[nodiscard]] std::string_view longName() const noexcept { return m_longName; }
+    [[nodiscard]] std::string_view name() const noexcept { return m_name; }
+    [[nodiscard]] std::string_view description() const noexcept { return m_description; }
+    [[nodiscard]] std::string_view defaultValue() const noexcept { return m_defaultValue; }
+    [[nodiscard]] std::string_view envName() const noexcept { return m_envName; }
     [[nodiscard]] ArgumentType type() const noexcept { return m_type; }
     [[nodiscard]] bool isRequired() const noexcept { return m_isRequired; }
-    [[nodiscard]] bool isSet() const noexcept { return m_isSet; }
+    [[nodiscard]] bool hasValidator() const noexcept { return m_validator || !m_checks.empty(); }
+    [[nodiscard]] bool isBound() const noexcept { return m_bindTarget != nullptr; }
+    [[nodiscard]] bool isSet() const noexcept { return m_value.isSet(); }
+    [[nodiscard]] std::size_t count() const noexcept { return m_value.count(); }
+    [[nodiscard]] bool isMultiValue() const noexcept { return m_append; }
+    [[nodiscard]] std::size_t nargs() const noexcept { return m_nargs; }
+    [[nodiscard]] std::span<const std::string_view> values() const noexcept { return m_value.values(); }
+    // Position in the owning parser's schema; indexes ParseResult storage.
+    [[nodiscard]] std::size_t index() const noexcept { return m_index; }
 
     void setValue(std::string_view value);
+    // Stores the view without copying; the caller keeps the characters alive.
+    void setValueView(std::string_view value);
+    // Non-throwing variants; return false for flags and rejected values.
+    [[nodiscard]] bool trySetValue(std::string_view value);
+    [[nodiscard]] bool trySetValueView(std::string_view value);
     void setFlag(bool value = true);
     
     template<typename T>
     [[nodiscard]] std::optional<T> get() const;
+
+    // Every value given, converted; the default alone when none was given.
+    // Throws ValidationError when a value does not convert.
+    template<typename T>
+    [[nodiscard]] std::vector<T> getAll() const;
     
     [[nodiscard]] std::string getString() const;
     [[nodiscard]] int getInt() const;
@@ -63,88 +204,222 @@ public:
     [[nodiscard]] bool validate(const std::string& value) const;
 
 private:
-    std::string m_shortName;
-    std::string m_longName;
-    std::string m_name;
-    std::string m_description;
-    std::string m_defaultValue;
-    std::string m_currentValue;
+    StringPool* m_strings;
+    std::string_view m_shortName;
+    std::string_view m_longName;
+    std::string_view m_name;
+    std::string_view m_description;
+    std::string_view m_defaultValue;
+    std::string_view m_envName;
     ArgumentType m_type;
     bool m_isRequired = false;
-    bool m_isSet = false;
+    bool m_append = false;
+    std::size_t m_nargs = 1;
     ValidatorFunction m_validator; 
+    ValueChecks m_checks;
+    ArgumentValue m_value;
+    std::size_t m_index = 0;
+    ArgumentTable* m_table = nullptr;
+    bool (*m_bind)(void* target, std::string_view value) = nullptr;
+    void* m_bindTarget = nullptr;
+
+    friend class ArgParser;
+
+    template<typename T>
+    static bool bindInto(void* target, std::string_view value) {
+        return convertValue(value, *static_cast<T*>(target));
+    }
+
+    [[nodiscard]] bool writeBound(std::string_view value) const {
+        return !m_bind || m_bind(m_bindTarget, value);
+    }
+
+    [[nodiscard]] bool accepts(std::string_view value) const;
+    [[nodiscard]] bool store(std::string_view value, bool owned);
+    void schemaChanged() noexcept;
+    void checksChanged();
+    void checkValue(std::string_view value) const;
 };
 
+template<typename T>
+Argument& Argument::bind(T& target) {
+
+    if (m_type == ArgumentType::Flag && !std::is_same_v<T, bool>) {
+        throw ArgumentError("Flags can only be bound to bool: " + std::string(m_longName));
+    }
+
+    m_bind = &bindInto<T>;
+    m_bindTarget = &target;
+
+    if (m_table) {
+        m_table->setBound(m_index, true);
+    }
+
+    return *this;
+}
+
 template<typename T>
 Argument& Argument::defaultValue(T value) {
     
     if constexpr (std::is_same_v<T, std::string>) {
-        m_defaultValue = value;
+        return defaultValue(std::string_view(value));
     
     } else if constexpr (std::is_arithmetic_v<T>) {
-        m_defaultValue = std::to_string(value);
+        return defaultValue(std::string_view(std::to_string(value)));
     
     } else {
         static_assert(sizeof(T) == 0, "Unsupported type for default value");
     }
-    
-    return *this;
 }
 
 template<typename T>
 std::optional<T> Argument::get() const {
 
-    if(!m_isSet && m_defaultValue.empty()) {
+    return m_value.get<T>(m_type, m_defaultValue);
+}
+
+template<typename T>
+std::vector<T> Argument::getAll() const {
+
+    return m_value.getAll<T>(m_defaultValue);
+}
+
+template<typename T>
+std::optional<T> ArgumentValue::get(ArgumentType type, std::string_view defaultValue) const {
+
+    if constexpr (std::is_same_v<T, std::span<const std::string_view>>) {
+
+        return m_isSet ? std::optional<T>(values()) : std::nullopt;
+    }
+
+    if(!m_isSet && defaultValue.empty()) {
         
         return std::nullopt;
     }
 
-    const std::string& value = m_isSet ? m_currentValue : m_defaultValue;
+    const std::string_view current = m_isSet ? value() : defaultValue;
 
     if constexpr (std::is_same_v<T, std::string>) {
 
-        return value;
-    
-    } else if constexpr (std::is_same_v<T, int>) {
+        return std::string(current);
 
-        try {
+    } else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, double> || std::is_same_v<T, bool>) {
 
-            return std::stoi(value);
+        if constexpr (std::is_same_v<T, bool>) {
 
-        } catch (...) {
+            if (type == ArgumentType::Flag) {
 
-            return std::nullopt;
+                return m_isSet;
+            }
         }
-    
+
+        return typedSlot<T>().get([current] { return convert<T>(current); });
+
+    } else if constexpr (!std::is_same_v<T, std::span<const std::string_view>>) {
+
+        return convert<T>(current);
+    }
+}
+
+template<typename T>
+const ArgumentValue::TypedSlot<T>& ArgumentValue::typedSlot() const noexcept {
+
+    if constexpr (std::is_same_v<T, int>) {
+        return m_int;
+
     } else if constexpr (std::is_same_v<T, double>) {
+        return m_double;
+
+    } else {
+        return m_bool;
+    }
+}
+
+template<typename T>
+auto ArgumentValue::TypedSlot<T>::operator=(const TypedSlot& other) noexcept -> TypedSlot& {
+    const auto state = other.m_state.load(std::memory_order_acquire);
 
-        try {
+    if (state == Valid || state == Invalid) {
+        m_value = other.m_value;
+        m_state.store(state, std::memory_order_relaxed);
 
-            return std::stod(value);
-        
-        } catch (...) {
+    } else {
+        m_state.store(Empty, std::memory_order_relaxed);
+    }
+
+    return *this;
+}
+
+template<typename T>
+template<typename Convert>
+std::optional<T> ArgumentValue::TypedSlot<T>::get(Convert&& convert) const {
+    const auto state = m_state.load(std::memory_order_acquire);
 
-            return std::nullopt;
+    if (state == Valid) {
+
+        return m_value;
+    }
+
+    if (state == Invalid) {
+
+        return std::nullopt;
+    }
+
+    std::optional<T> result = convert();
+    std::uint8_t expected = Empty;
+
+    if (m_state.compare_exchange_strong(expected, Filling, std::memory_order_acquire)) {
+
+        if (result) {
+            m_value = *result;
         }
-    
-    } else if constexpr (std::is_same_v<T, bool>) { 
+        m_state.store(result ? Valid : Invalid, std::memory_order_release);
+    }
+
+    return result;
+}
+
+template<typename T>
+std::vector<T> ArgumentValue::getAll(std::string_view defaultValue) const {
+    std::vector<T> result;
+    const auto given = values();
 
-        if (m_type == ArgumentType::Flag) {
+    if (given.empty() && defaultValue.empty()) {
 
-            return m_isSet;
+        return result;
+    }
+
+    const auto all = given.empty() ? std::span<const std::string_view>(&defaultValue, 1) : given;
+    result.reserve(all.size());
+
+    for (const auto value : all) {
+
+        if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>) {
+            result.emplace_back(value);
+
+        } else {
+            auto converted = convert<T>(value);
+
+            if (!converted) {
+                throw ValidationError("Cannot convert value: " + std::string(value));
+            }
+            result.push_back(*converted);
         }
+    }
 
-        std::string lowerValue = value;
-        std::transform(lowerValue.begin(), lowerValue.end(),
-                        lowerValue.begin(), [](char c) 
-                        { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+    return result;
+}
 
-        return (lowerValue == "true" || lowerValue == "1"||
-                lowerValue == "yes" || lowerValue == "on");
-    
-    } else {
-        static_assert(sizeof(T) == 0, "Unsupported type for get()");
+template<typename T>
+std::optional<T> ArgumentValue::convert(std::string_view value) {
+    T result{};
+
+    if (!convertValue(value, result)) {
+
+        return std::nullopt;
     }
+
+    return result;
 }
 
 }
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace argparser {
+
+struct StringHash {
+    using is_transparent = void;
+
+    [[nodiscard]] std::size_t operator()(std::string_view value) const noexcept {
+        return std::hash<std::string_view>{}(value);
+    }
+};
+
+enum class ArgumentType : std::uint8_t {
+    Flag,
+    Option,
+    Positional
+};
+
+// Hot per-argument schema data in contiguous arrays, so the scans done on
+// every parse (required check, positional assignment, usage line) stay off
+// the Argument objects and their strings.
+class ArgumentTable {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    using EnvBindings = std::pmr::unordered_map<std::pmr::string, std::uint32_t, StringHash, std::equal_to<>>;
+
+    struct NameEntry {
+        std::string_view name;
+        std::uint32_t index = 0;
+    };
+
+    static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+    explicit ArgumentTable(const allocator_type& alloc = {})
+        : m_types(alloc), m_required(alloc), m_requiredMask(alloc), m_positionals(alloc), m_bound(alloc), m_checked(alloc), m_env(alloc), m_longNames(alloc) {
+        m_shortNames.fill(npos);
+    }
+
+    void add(ArgumentType type, bool required, std::size_t labelWidth);
+    void setRequired(std::size_t index, bool required);
+    void setBound(std::size_t index, bool bound);
+    void setChecked(std::size_t index, bool checked);
+    // Single ASCII character short names resolve through a direct-indexed table.
+    void setShortName(char name, std::size_t index) noexcept;
+
+    [[nodiscard]] std::uint32_t findShort(char name) const noexcept {
+        const auto code = static_cast<unsigned char>(name);
+
+        return code < m_shortNames.size() ? m_shortNames[code] : npos;
+    }
+
+    // Long names feed a sorted index for prefix matches and suggestions. The
+    // name must outlive the table. Until freeze() sorts the index again,
+    // queries fall back to a linear scan so they stay correct.
+    void addLongName(std::string_view name, std::size_t index);
+    void freeze();
+    [[nodiscard]] bool frozen() const noexcept { return m_frozen; }
+
+    // Index of the only argument whose long name starts with prefix, or npos;
+    // ambiguous is set when the prefix matches more than one argument.
+    [[nodiscard]] std::uint32_t findPrefix(std::string_view prefix, bool& ambiguous) const;
+
+    template <typename Visitor>
+    void visitPrefix(std::string_view prefix, Visitor&& visit) const;
+
+    // Closest long name within a small edit distance of name, or empty.
+    [[nodiscard]] std::string_view suggest(std::string_view name) const;
+    // Replaces the environment variable bound to the argument; empty unbinds it.
+    // Throws ArgumentError if another argument is bound to the variable.
+    void bindEnv(std::size_t index, std::string_view name);
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_types.size(); }
+    [[nodiscard]] std::span<const ArgumentType> types() const noexcept { return m_types; }
+    [[nodiscard]] std::span<const std::uint32_t> required() const noexcept { return m_required; }
+    // The required arguments again as one bit per argument index, 64 to a word.
+    [[nodiscard]] std::span<const std::uint64_t> requiredMask() const noexcept { return m_requiredMask; }
+    [[nodiscard]] std::span<const std::uint32_t> positionals() const noexcept { return m_positionals; }
+    // Arguments written into caller storage by Argument::bind().
+    [[nodiscard]] std::span<const std::uint32_t> bound() const noexcept { return m_bound; }
+    // Arguments with a validator or built-in checks, for deferred validation.
+    [[nodiscard]] std::span<const std::uint32_t> checked() const noexcept { return m_checked; }
+    [[nodiscard]] bool hasOptions() const noexcept { return m_optionCount != 0; }
+    // Widest "-s, --long" or positional name, used to align the help columns.
+    [[nodiscard]] std::size_t labelWidth() const noexcept { return m_labelWidth; }
+    [[nodiscard]] const EnvBindings& envBindings() const noexcept { return m_env; }
+
+    // Bumped on every schema change; lets cached state detect staleness.
+    [[nodiscard]] std::uint64_t revision() const noexcept { return m_revision; }
+    void touch() noexcept { ++m_revision; }
+
+private:
+    std::pmr::vector<ArgumentType> m_types;
+    std::pmr::vector<std::uint32_t> m_required;
+    std::pmr::vector<std::uint64_t> m_requiredMask;
+    std::pmr::vector<std::uint32_t> m_positionals;
+    std::pmr::vector<std::uint32_t> m_bound;
+    std::pmr::vector<std::uint32_t> m_checked;
+    EnvBindings m_env;
+    std::array<std::uint32_t, 128> m_shortNames;
+    std::pmr::vector<NameEntry> m_longNames;
+    bool m_frozen = true;
+    std::size_t m_optionCount = 0;
+    std::size_t m_labelWidth = 0;
+    std::uint64_t m_revision = 0;
+};
+
+template <typename Visitor>
+void ArgumentTable::visitPrefix(std::string_view prefix, Visitor&& visit) const {
+
+    if (!m_frozen) {
+
+        for (const auto& entry : m_longNames) {
+
+            if (entry.name.starts_with(prefix)) {
+                visit(entry);
+            }
+        }
+
+        return;
+    }
+
+    auto it = std::lower_bound(m_longNames.begin(), m_longNames.end(), prefix,
+                                [](const NameEntry& entry, std::string_view value) {
+                                    return entry.name < value;
+                                });
+
+    for (; it != m_longNames.end() && it->name.starts_with(prefix); ++it) {
+        visit(*it);
+    }
+}
+
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "Converter.hpp"
+#include "ParseErrorInfo.hpp"
+#include "ParseResult.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace argparser {
+
+class ArgParser;
+
+// One command line of a batch: the tokens after the program name. The views
+// must stay valid for as long as the BatchResult is in use.
+struct CommandLine {
+    std::span<const std::string_view> arguments;
+};
+
+// Runs the tasks of a batch parse. Implement it to hand the work to an
+// existing thread pool.
+class Executor {
+public:
+    virtual ~Executor() = default;
+
+    // Number of tasks that can make progress at the same time.
+    [[nodiscard]] virtual std::size_t concurrency() const noexcept = 0;
+
+    // Calls task(0) to task(count - 1), possibly in parallel, and returns once
+    // all of them have finished. The first exception a task throws is rethrown.
+    virtual void run(std::size_t count, const std::function<void(std::size_t)>& task) = 0;
+};
+
+class InlineExecutor final : public Executor {
+public:
+    [[nodiscard]] std::size_t concurrency() const noexcept override { return 1; }
+
+    void run(std::size_t count, const std::function<void(std::size_t)>& task) override {
+
+        for (std::size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+    }
+};
+
+// Fixed set of threads; the thread calling run() works on the tasks as well,
+// so threads - 1 workers are started. Concurrent run() calls take turns.
+class ThreadPoolExecutor final : public Executor {
+public:
+    explicit ThreadPoolExecutor(std::size_t threads = std::thread::hardware_concurrency());
+    ~ThreadPoolExecutor() override;
+
+    ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+    [[nodiscard]] std::size_t concurrency() const noexcept override { return m_workers.size() + 1; }
+
+    void run(std::size_t count, const std::function<void(std::size_t)>& task) override;
+
+private:
+    std::mutex m_runMutex;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::vector<std::thread> m_workers;
+    const std::function<void(std::size_t)>* m_task = nullptr;
+    std::size_t m_count = 0;
+    std::size_t m_next = 0;
+    std::size_t m_pending = 0;
+    std::exception_ptr m_error;
+    bool m_stop = false;
+
+    void workerLoop();
+    void runPending(std::unique_lock<std::mutex>& lock);
+};
+
+// How the parse of one batch row ended. Only Ok rows carry their values; the
+// others keep the defaults in every column.
+enum class RowState : std::uint8_t {
+    Ok,
+    HelpRequested,
+    VersionRequested,
+    Error
+};
+
+struct BatchError {
+    std::size_t row = 0;
+    ParseErrorInfo info;
+};
+
+// Values of a batch parse laid out per argument, so one option can be scanned
+// across every row. Columns follow the order the arguments were added in.
+// Values point into the command lines or into the schema's defaults.
+class BatchResult {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    explicit BatchResult(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_values(resource), m_counts(resource), m_subcommands(resource), m_states(resource),
+        m_errors(resource), m_slabs(resource) {}
+
+    [[nodiscard]] std::size_t rows() const noexcept { return m_rows; }
+    [[nodiscard]] std::size_t columns() const noexcept { return m_columns; }
+
+    // Column of the argument with the given short, long or positional name, or npos.
+    [[nodiscard]] std::size_t column(std::string_view name) const;
+
+    // Per row the last value given, or the default when the row did not give
+    // the argument. Flags read "true" or "false".
+    [[nodiscard]] std::span<const std::string_view> values(std::size_t column) const noexcept {
+        return std::span<const std::string_view>(m_values).subspan(column * m_rows, m_rows);
+    }
+
+    // How often each row gave the argument.
+    [[nodiscard]] std::span<const std::uint32_t> counts(std::size_t column) const noexcept {
+        return std::span<const std::uint32_t>(m_counts).subspan(column * m_rows, m_rows);
+    }
+
+    // Subcommand named by each row, or empty.
+    [[nodiscard]] std::span<const std::string_view> subcommands() const noexcept { return m_subcommands; }
+
+    // A row that asked for help or the version is not a failure, but it keeps
+    // the defaults like one; nothing is printed for it either way.
+    [[nodiscard]] RowState state(std::size_t row) const noexcept { return m_states[row]; }
+    [[nodiscard]] bool failed(std::size_t row) const noexcept { return m_states[row] == RowState::Error; }
+    // Errors of the failed rows, in row order.
+    [[nodiscard]] std::span<const BatchError> errors() const noexcept { return m_errors; }
+
+    template <typename T>
+    [[nodiscard]] std::optional<T> get(std::size_t column, std::size_t row) const;
+
+private:
+    friend class ArgParser;
+
+    // Parse state owned by one task, reused for every row it parses.
+    struct Slab {
+        explicit Slab(std::pmr::memory_resource* resource) : result(resource), errors(resource) {}
+
+        ParseResult result;
+        std::pmr::vector<BatchError> errors;
+    };
+
+    const ArgParser* m_schema = nullptr;
+    std::size_t m_rows = 0;
+    std::size_t m_columns = 0;
+    std::pmr::vector<std::string_view> m_values;
+    std::pmr::vector<std::uint32_t> m_counts;
+    std::pmr::vector<std::string_view> m_subcommands;
+    std::pmr::vector<RowState> m_states;
+    std::pmr::vector<BatchError> m_errors;
+    // Kept across parses so a reused BatchResult also reuses the slabs' buffers.
+    std::pmr::deque<Slab> m_slabs;
+};
+
+template <typename T>
+std::optional<T> BatchResult::get(std::size_t column, std::size_t row) const {
+    T value{};
+
+    if (!convertValue(m_values[column * m_rows + row], value)) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "ArgumentTable.hpp"
+#include "Converter.hpp"
+#include "Exceptions.hpp"
+#include "MappedFile.hpp"
+#include "ParseErrorInfo.hpp"
+#include "TokenSource.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace argparser {
+
+class ArgParser;
+class CompiledResult;
+
+// Read-only view of a schema blob written by ArgParser::freeze(blob). Nothing
+// is built when it is loaded: names resolve through the blob's perfect hash
+// table, and every string handed out is a view into the blob, which must
+// outlive the schema and the results parsed against it.
+//
+// The blob holds the argument metadata only. Validators, checks, bindings,
+// environment variables and subcommands cannot be written into it.
+class CompiledSchema {
+public:
+    static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+    // Checks the header and that every section and string lies inside the
+    // blob; throws ArgumentError otherwise. The blob needs no alignment.
+    explicit CompiledSchema(std::string_view blob);
+
+    // Memory-maps the blob from a file and keeps the mapping alive.
+    [[nodiscard]] static CompiledSchema open(const std::string& path);
+
+    [[nodiscard]] std::string_view blob() const noexcept { return m_blob; }
+    [[nodiscard]] std::size_t size() const noexcept { return m_argumentCount; }
+
+    [[nodiscard]] std::string_view programName() const noexcept { return m_programName; }
+    [[nodiscard]] std::string_view description() const noexcept { return m_description; }
+    [[nodiscard]] std::string_view version() const noexcept { return m_version; }
+
+    // Index of the argument with the given short, long or positional name, or npos.
+    [[nodiscard]] std::uint32_t find(std::string_view name) const noexcept;
+    [[nodiscard]] std::uint32_t findShort(char name) const noexcept;
+
+    [[nodiscard]] ArgumentType type(std::size_t index) const noexcept;
+    [[nodiscard]] std::string_view shortName(std::size_t index) const noexcept;
+    [[nodiscard]] std::string_view longName(std::size_t index) const noexcept;
+    [[nodiscard]] std::string_view name(std::size_t index) const noexcept;
+    [[nodiscard]] std::string_view description(std::size_t index) const noexcept;
+    [[nodiscard]] std::string_view defaultValue(std::size_t index) const noexcept;
+    [[nodiscard]] bool isRequired(std::size_t index) const noexcept;
+    [[nodiscard]] bool isMultiValue(std::size_t index) const noexcept;
+    [[nodiscard]] std::size_t nargs(std::size_t index) const noexcept;
+
+    // The result is cleared first. Tokens are classified and split at '=' by
+    // the same splitToken() as ArgParser, and long options, short clusters,
+    // nargs(), append() and positionals behave the same. This path does not
+    // handle:
+    //   - abbreviated long options and "did you mean" suggestions,
+    //   - @file response files,
+    //   - -h, --help and --version, which are unknown unless declared,
+    //   - validators and built-in checks, which freeze(blob) rejects,
+    //   - environment variables, config files, bindings and subcommands,
+    //   - the positional sink and lazy() parsing.
+    // Values are not converted until they are read.
+    void parseOptions(int argc, char* argv[], CompiledResult& result) const;
+    [[nodiscard]] std::optional<ParseErrorInfo> tryParse(int argc, char* argv[], CompiledResult& result) const;
+    [[nodiscard]] std::optional<ParseErrorInfo> tryParse(TokenSource& source, CompiledResult& result) const;
+
+private:
+    friend class ArgParser;
+
+    std::optional<MappedFile> m_file;
+    std::string_view m_blob;
+    std::uint32_t m_argumentCount = 0;
+    std::uint32_t m_bucketCount = 0;
+    std::uint32_t m_slotCount = 0;
+    std::uint32_t m_positionalCount = 0;
+    std::uint32_t m_requiredCount = 0;
+    const char* m_records = nullptr;
+    const char* m_shortNames = nullptr;
+    const char* m_displacements = nullptr;
+    const char* m_slots = nullptr;
+    const char* m_positionals = nullptr;
+    const char* m_required = nullptr;
+    std::string_view m_strings;
+    std::string_view m_programName;
+    std::string_view m_description;
+    std::string_view m_version;
+
+    [[nodiscard]] std::string_view string(const char* ref) const noexcept;
+    [[nodiscard]] const char* record(std::size_t index) const noexcept;
+    // "--long", "-s" or the positional name, for error messages.
+    [[nodiscard]] std::string_view label(std::size_t index) const noexcept;
+
+    // Serializes parser's schema; see ArgParser::freeze(std::string&).
+    static void write(const ArgParser& parser, std::string& blob);
+};
+
+// C++ source for a header that embeds blob as an inline constexpr
+// std::string_view called name, so a binary can carry its schema:
+//
+//     #include "tool_schema.hpp"
+//     static const argparser::CompiledSchema schema(toolSchema);
+[[nodiscard]] std::string formatSchemaSource(std::string_view blob, std::string_view name);
+
+// Values parsed against a CompiledSchema; views into the command line or the
+// schema blob. Reusing a result keeps its buffers.
+class CompiledResult {
+public:
+    explicit CompiledResult(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_values(resource), m_counts(resource), m_multiValues(resource), m_positionals(resource),
+        m_touched(resource) {}
+
+    // Only resets the entries the last parse wrote to.
+    void clear() noexcept;
+
+    template <typename T>
+    [[nodiscard]] std::optional<T> get(std::string_view name) const;
+    template <typename T>
+    [[nodiscard]] std::vector<T> getAll(std::string_view name) const;
+
+    [[nodiscard]] std::string getString(std::string_view name) const;
+    [[nodiscard]] bool isSet(std::string_view name) const;
+    [[nodiscard]] std::size_t count(std::string_view name) const;
+
+    [[nodiscard]] std::span<const std::string_view> positionalViews() const noexcept { return m_positionals; }
+
+private:
+    friend class CompiledSchema;
+
+    struct MultiValue {
+        std::uint32_t index;
+        std::string_view value;
+    };
+
+    const CompiledSchema* m_schema = nullptr;
+    std::pmr::vector<std::string_view> m_values;
+    std::pmr::vector<std::uint32_t> m_counts;
+    std::pmr::vector<MultiValue> m_multiValues;
+    std::pmr::vector<std::string_view> m_positionals;
+    std::pmr::vector<std::uint32_t> m_touched;
+
+    void store(std::uint32_t index, std::string_view value);
+    [[nodiscard]] std::uint32_t indexOf(std::string_view name) const noexcept;
+};
+
+template <typename T>
+std::optional<T> CompiledResult::get(std::string_view name) const {
+    const auto index = indexOf(name);
+
+    if (index == CompiledSchema::npos) {
+        return std::nullopt;
+    }
+
+    if constexpr (std::is_same_v<T, bool>) {
+
+        if (m_schema->type(index) == ArgumentType::Flag) {
+            return m_counts[index] != 0;
+        }
+    }
+
+    const auto value = m_counts[index] != 0 ? m_values[index] : m_schema->defaultValue(index);
+
+    if (m_counts[index] == 0 && value.empty()) {
+        return std::nullopt;
+    }
+
+    T converted{};
+
+    if (!convertValue(value, converted)) {
+        return std::nullopt;
+    }
+
+    return converted;
+}
+
+template <typename T>
+std::vector<T> CompiledResult::getAll(std::string_view name) const {
+    std::vector<T> result;
+    const auto index = indexOf(name);
+
+    // Flags carry no values, the same as in ParseResult.
+    if (index == CompiledSchema::npos || m_schema->type(index) == ArgumentType::Flag) {
+        return result;
+    }
+
+    auto add = [&result](std::string_view value) {
+        T converted{};
+
+        if (!convertValue(value, converted)) {
+            throw ValidationError("Cannot convert value: " + std::string(value));
+        }
+        result.push_back(std::move(converted));
+    };
+
+    if (m_counts[index] == 0) {
+        const auto fallback = m_schema->defaultValue(index);
+
+        if (!fallback.empty()) {
+            add(fallback);
+        }
+
+        return result;
+    }
+
+    if (!m_schema->isMultiValue(index)) {
+        add(m_values[index]);
+
+        return result;
+    }
+
+    for (const auto& entry : m_multiValues) {
+
+        if (entry.index == index) {
+            add(entry.value);
+        }
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace argparser {
+
+// One "key = value" line of a config file. Both parts are views into the
+// contents, trimmed, and a value in matching single or double quotes loses
+// the quotes; nothing inside is unescaped.
+struct ConfigEntry {
+    std::string_view key;
+    std::string_view value;
+    std::size_t line = 0;
+};
+
+// Splits INI-style contents into entries in one pass while the caller asks
+// for them. Blank lines and lines starting with '#' or ';' are skipped, and
+// an unquoted value ends at a '#' that follows whitespace. Section headers
+// and lines without '=' are malformed.
+class ConfigReader {
+public:
+    explicit ConfigReader(std::string_view contents) noexcept
+        : m_contents(contents) {}
+
+    // False at the end of the contents or at a malformed line.
+    [[nodiscard]] bool next(ConfigEntry& entry) noexcept;
+
+    // Line number of the malformed line that stopped the reader, or 0.
+    [[nodiscard]] std::size_t errorLine() const noexcept { return m_errorLine; }
+
+private:
+    std::string_view m_contents;
+    std::size_t m_position = 0;
+    std::size_t m_line = 0;
+    std::size_t m_errorLine = 0;
+};
+
+}
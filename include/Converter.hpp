@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace argparser {
+
+// Text-to-value conversion behind get<T>(), getAll<T>(), bind() and
+// StaticSchema. parse() has to consume the whole token and leaves out
+// unchanged when it fails; nothing throws and nothing depends on the locale.
+// Specialize it to make get<T>() and bind() accept a type of your own:
+//
+//     template <> struct argparser::Converter<Port> {
+//         static bool parse(std::string_view text, Port& out) noexcept;
+//     };
+template <typename T>
+struct Converter {
+    static bool parse(std::string_view, T&) {
+        static_assert(sizeof(T) == 0, "No argparser::Converter specialization for this type");
+
+        return false;
+    }
+};
+
+// Byte count written as a number with an optional unit: 512, 10MB, 4KiB, 1.5GiB.
+struct ByteSize {
+    std::uint64_t bytes = 0;
+
+    friend bool operator==(ByteSize, ByteSize) = default;
+};
+
+// Fill in values to convert an enum by name:
+//
+//     template <> struct argparser::EnumNames<Level> {
+//         static constexpr std::array<std::pair<std::string_view, Level>, 2> values{{
+//             {"debug", Level::Debug}, {"info", Level::Info}}};
+//     };
+template <typename E>
+struct EnumNames;
+
+template <typename E>
+concept NamedEnum = std::is_enum_v<E> && requires { EnumNames<E>::values; };
+
+namespace detail {
+
+struct Unit {
+    std::string_view suffix;
+    std::uint64_t scale;
+};
+
+inline constexpr std::array<Unit, 8> durationUnits{{
+    {"ns", 1}, {"us", 1'000}, {"ms", 1'000'000}, {"s", 1'000'000'000},
+    {"m", 60'000'000'000}, {"min", 60'000'000'000}, {"h", 3'600'000'000'000}, {"d", 86'400'000'000'000},
+}};
+
+inline constexpr std::array<Unit, 14> sizeUnits{{
+    {"", 1}, {"B", 1},
+    {"K", 1'000}, {"KB", 1'000}, {"M", 1'000'000}, {"MB", 1'000'000},
+    {"G", 1'000'000'000}, {"GB", 1'000'000'000}, {"T", 1'000'000'000'000}, {"TB", 1'000'000'000'000},
+    {"KiB", 1ull << 10}, {"MiB", 1ull << 20}, {"GiB", 1ull << 30}, {"TiB", 1ull << 40},
+}};
+
+// A number with a leading '+' is accepted; from_chars itself only takes '-'.
+[[nodiscard]] inline const char* skipPlus(const char* first, const char* last) noexcept {
+    return (first != last && *first == '+' && first + 1 != last && *(first + 1) != '-') ? first + 1 : first;
+}
+
+// Reads "<number><unit>" and returns number * scale of the unit. The digits are
+// read exactly and multiplied in integers, so a decimal number is accepted only
+// when the product is whole and fits Out.
+template <typename Out>
+[[nodiscard]] bool parseScaled(std::string_view text, std::span<const Unit> units, Out& out) noexcept {
+    const char* last = text.data() + text.size();
+    const char* first = skipPlus(text.data(), last);
+    const bool negative = first != last && *first == '-';
+
+    if (negative) {
+
+        if constexpr (std::is_unsigned_v<Out>) {
+            return false;
+        }
+        ++first;
+    }
+
+    if (first == last || *first < '0' || *first > '9') {
+        return false;
+    }
+
+    std::uint64_t whole = 0;
+    auto [end, ec] = std::from_chars(first, last, whole);
+
+    if (ec != std::errc()) {
+        return false;
+    }
+
+    const char* fraction = end;
+    const char* fractionEnd = end;
+
+    if (end != last && *end == '.') {
+        fraction = end + 1;
+        fractionEnd = std::find_if(fraction, last, [](char c) { return c < '0' || c > '9'; });
+        end = fractionEnd;
+    }
+
+    const std::string_view suffix(end, static_cast<std::size_t>(last - end));
+    std::uint64_t scale = 0;
+
+    for (const auto& unit : units) {
+
+        if (unit.suffix == suffix) {
+            scale = unit.scale;
+
+            break;
+        }
+    }
+
+    if (scale == 0) {
+        return false;
+    }
+
+    // The fraction's share of the product, from the last digit up: every
+    // division by ten has to be exact, otherwise the product is not whole.
+    // The running value stays below 10 * scale.
+    std::uint64_t part = 0;
+
+    for (const char* digit = fractionEnd; digit != fraction; --digit) {
+        part += static_cast<std::uint64_t>(*(digit - 1) - '0') * scale;
+
+        if (part % 10 != 0) {
+            return false;
+        }
+        part /= 10;
+    }
+
+    constexpr auto maximum = std::numeric_limits<std::uint64_t>::max();
+
+    if (whole > (maximum - part) / scale) {
+        return false;
+    }
+
+    const std::uint64_t magnitude = whole * scale + part;
+    // A negative Out reaches one further than its maximum.
+    const auto limit = static_cast<std::uint64_t>(std::numeric_limits<Out>::max()) + (negative ? 1 : 0);
+
+    if (magnitude > limit) {
+        return false;
+    }
+
+    if constexpr (std::is_signed_v<Out>) {
+        out = negative ? static_cast<Out>(0 - magnitude) : static_cast<Out>(magnitude);
+    } else {
+        out = static_cast<Out>(magnitude);
+    }
+
+    return true;
+}
+
+}
+
+template <typename T>
+    requires std::integral<T> && (!std::same_as<T, bool>)
+struct Converter<T> {
+    static bool parse(std::string_view text, T& out) noexcept {
+        const char* last = text.data() + text.size();
+        T value{};
+        auto [ptr, ec] = std::from_chars(detail::skipPlus(text.data(), last), last, value);
+
+        if (ec != std::errc() || ptr != last) {
+            return false;
+        }
+        out = value;
+
+        return true;
+    }
+};
+
+template <std::floating_point T>
+struct Converter<T> {
+    static bool parse(std::string_view text, T& out) noexcept {
+        const char* last = text.data() + text.size();
+        T value{};
+        auto [ptr, ec] = std::from_chars(detail::skipPlus(text.data(), last), last, value);
+
+        if (ec != std::errc() || ptr != last) {
+            return false;
+        }
+        out = value;
+
+        return true;
+    }
+};
+
+// true/false, 1/0, yes/no and on/off, in any letter case.
+template <>
+struct Converter<bool> {
+    static bool parse(std::string_view text, bool& out) noexcept {
+        auto equals = [text](std::string_view expected) {
+            return text.length() == expected.length() &&
+                    std::equal(text.begin(), text.end(), expected.begin(), [](char lhs, char rhs) {
+                        return (lhs >= 'A' && lhs <= 'Z' ? static_cast<char>(lhs - 'A' + 'a') : lhs) == rhs;
+                    });
+        };
+
+        if (equals("true") || equals("1") || equals("yes") || equals("on")) {
+            out = true;
+
+            return true;
+        }
+
+        if (equals("false") || equals("0") || equals("no") || equals("off")) {
+            out = false;
+
+            return true;
+        }
+
+        return false;
+    }
+};
+
+template <>
+struct Converter<std::string> {
+    static bool parse(std::string_view text, std::string& out) {
+        out.assign(text);
+
+        return true;
+    }
+};
+
+template <>
+struct Converter<std::string_view> {
+    static bool parse(std::string_view text, std::string_view& out) noexcept {
+        out = text;
+
+        return true;
+    }
+};
+
+// 250ms, 1.5s, 10min: ns, us, ms, s, m or min, h and d. A unit is required, and
+// a value the target cannot hold exactly (1500ms into seconds) is rejected.
+template <typename Rep, typename Period>
+struct Converter<std::chrono::duration<Rep, Period>> {
+    using Duration = std::chrono::duration<Rep, Period>;
+
+    static bool parse(std::string_view text, Duration& out) noexcept {
+        std::int64_t count = 0;
+
+        if (!detail::parseScaled(text, detail::durationUnits, count)) {
+            return false;
+        }
+
+        const std::chrono::nanoseconds total(count);
+        const auto converted = std::chrono::duration_cast<Duration>(total);
+
+        if constexpr (!std::is_floating_point_v<Rep>) {
+
+            if (std::chrono::duration_cast<std::chrono::nanoseconds>(converted) != total) {
+                return false;
+            }
+        }
+        out = converted;
+
+        return true;
+    }
+};
+
+template <>
+struct Converter<ByteSize> {
+    static bool parse(std::string_view text, ByteSize& out) noexcept {
+        return detail::parseScaled(text, detail::sizeUnits, out.bytes);
+    }
+};
+
+template <NamedEnum E>
+struct Converter<E> {
+    static bool parse(std::string_view text, E& out) noexcept {
+
+        for (const auto& [name, value] : EnumNames<E>::values) {
+
+            if (name == text) {
+                out = value;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+template <typename T>
+[[nodiscard]] bool convertValue(std::string_view value, T& out) {
+    return Converter<T>::parse(value, out);
+}
+
+}
@@ -35,4 +35,10 @@ public:
         : ArgumentError("Unknown argument: " + message) {}
 };
 
+class AmbiguousArgumentError : public ArgumentError{
+public:
+    explicit AmbiguousArgumentError(const std::string &message)
+        : ArgumentError("Ambiguous argument: " + message) {}
+};
+
 }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace argparser {
+
+// Read-only view of a whole file. On POSIX systems the file is memory-mapped;
+// elsewhere it is read into an owned buffer. Moving keeps contents() valid.
+class MappedFile {
+public:
+    MappedFile() noexcept = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    [[nodiscard]] static std::optional<MappedFile> open(const std::string& path);
+
+    [[nodiscard]] std::string_view contents() const noexcept { return {m_data, m_size}; }
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_mapped = false;
+
+    void release() noexcept;
+};
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace argparser {
+
+// Destination of the help and version text a parser prints. Each message
+// arrives in one write() call, newline included; flushing is left to the sink.
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    virtual void write(std::string_view text) = 0;
+};
+
+// Writes to a stream without flushing it.
+class StreamSink final : public OutputSink {
+public:
+    explicit StreamSink(std::ostream& stream) noexcept
+        : m_stream(stream) {}
+
+    void write(std::string_view text) override;
+
+private:
+    std::ostream& m_stream;
+};
+
+// Appends to a caller-owned string; reserve it up front to keep printing
+// allocation-free.
+class StringSink final : public OutputSink {
+public:
+    explicit StringSink(std::string& buffer) noexcept
+        : m_buffer(buffer) {}
+
+    void write(std::string_view text) override { m_buffer.append(text); }
+
+private:
+    std::string& m_buffer;
+};
+
+// The sink parsers print to unless given another: a StreamSink over std::cout.
+[[nodiscard]] OutputSink& standardOutput();
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace argparser {
+
+class Argument;
+class ArgumentTable;
+
+enum class ParseErrorCode {
+    UnknownArgument,
+    MissingValue,
+    UnexpectedValue,
+    InvalidValue,
+    MissingRequired,
+    InvalidResponseFile,
+    AmbiguousArgument
+};
+
+// Describes a failed parse without allocating. The views point into the parsed
+// tokens; message() and raise() build the text only when asked for it.
+struct ParseErrorInfo {
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    ParseErrorCode code;
+    std::size_t tokenIndex = npos;
+    std::string_view token;
+    std::string_view value;
+    const Argument* argument = nullptr;
+    // Set for unknown and ambiguous long options; message() looks up
+    // "did you mean" suggestions and candidates in it.
+    const ArgumentTable* schema = nullptr;
+
+    [[nodiscard]] std::string message() const;
+    [[noreturn]] void raise() const;
+};
+
+}
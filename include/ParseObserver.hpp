@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+
+// Set through the ARGPARSER_INSTRUMENTATION CMake option. When it is off the
+// parse loop has no timing code at all and observers are never called.
+#ifndef ARGPARSER_INSTRUMENTATION
+#define ARGPARSER_INSTRUMENTATION 0
+#endif
+
+namespace argparser {
+
+class Argument;
+
+inline constexpr bool instrumentationEnabled = ARGPARSER_INSTRUMENTATION != 0;
+
+enum class ParsePhase : std::uint8_t {
+    Tokenize,
+    Lookup,
+    Validate,
+    Environment,
+    Required
+};
+
+inline constexpr std::size_t parsePhaseCount = 5;
+
+// Measurements for one parse. Validators run for environment values are also
+// part of the Environment phase.
+struct ParseStats {
+    std::array<std::chrono::nanoseconds, parsePhaseCount> phases{};
+    std::chrono::nanoseconds total{};
+    std::size_t tokens = 0;
+    std::size_t lookups = 0;
+    std::size_t validatorCalls = 0;
+    std::size_t slowValidators = 0;
+    // Only counted when the parser's (or the ParseResult's) resource is a CountingResource.
+    std::size_t allocations = 0;
+    bool failed = false;
+
+    [[nodiscard]] std::chrono::nanoseconds phase(ParsePhase which) const noexcept {
+        return phases[static_cast<std::size_t>(which)];
+    }
+};
+
+// Attached with ArgParser::observer(). Callbacks run on the parsing thread, so
+// an observer shared by concurrent parses must be thread-safe itself.
+class ParseObserver {
+public:
+    virtual ~ParseObserver() = default;
+
+    [[nodiscard]] virtual std::chrono::nanoseconds slowValidatorThreshold() const noexcept {
+        return std::chrono::microseconds(100);
+    }
+
+    // Bracket every validator call, e.g. to open and close a tracing span.
+    virtual void onValidatorBegin(const Argument& /*argument*/) {}
+    virtual void onValidatorEnd(const Argument& /*argument*/, std::string_view /*value*/,
+                                std::chrono::nanoseconds /*elapsed*/) {}
+
+    // A validator call that took at least slowValidatorThreshold().
+    virtual void onSlowValidator(const Argument& /*argument*/, std::string_view /*value*/,
+                                std::chrono::nanoseconds /*elapsed*/) {}
+
+    virtual void onParse(const ParseStats& /*stats*/) {}
+};
+
+// Forwards to upstream and counts what goes through. Concurrent parses sharing
+// the resource all show up in each other's ParseStats::allocations.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : m_upstream(upstream) {}
+
+    [[nodiscard]] std::size_t allocations() const noexcept { return m_allocations.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::size_t bytes() const noexcept { return m_bytes.load(std::memory_order_relaxed); }
+
+private:
+    std::pmr::memory_resource* m_upstream;
+    std::atomic<std::size_t> m_allocations{0};
+    std::atomic<std::size_t> m_bytes{0};
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        m_allocations.fetch_add(1, std::memory_order_relaxed);
+        m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+        return m_upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        m_upstream->deallocate(ptr, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}
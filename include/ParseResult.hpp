@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Argument.hpp"
+#include "MappedFile.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace argparser {
+
+class ArgParser;
+
+// How far a parse got. A help or version request stops the parse at that
+// token; the values read before it are kept, and required arguments are not
+// checked.
+enum class ParseState : std::uint8_t {
+    Complete,
+    HelpRequested,
+    VersionRequested
+};
+
+// Per-parse storage filled by ArgParser::parseOptions(argc, argv, result).
+// The schema stays in the parser; a result can be cleared and reused for the
+// next command line without giving back its buffers.
+//
+// A result parsed by a lazy() parser checks each argument and applies its
+// environment fallback on the first read, so its reads may throw
+// ValidationError and must not run concurrently.
+class ParseResult {
+public:
+    explicit ParseResult(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_values(resource), m_positionals(resource), m_touched(resource), m_setBits(resource),
+        m_resolvedBits(resource), m_mappedFiles(resource) {}
+
+    // Only resets the entries the last parse wrote to.
+    void clear() noexcept;
+
+    template <typename T>
+    [[nodiscard]] std::optional<T> get(std::string_view name) const;
+    template <typename T>
+    [[nodiscard]] std::vector<T> getAll(std::string_view name) const;
+
+    [[nodiscard]] std::string getString(std::string_view name) const;
+    [[nodiscard]] int getInt(std::string_view name) const;
+    [[nodiscard]] double getDouble(std::string_view name) const;
+    [[nodiscard]] bool getBool(std::string_view name) const;
+
+    [[nodiscard]] bool isSet(std::string_view name) const;
+    [[nodiscard]] std::size_t count(std::string_view name) const;
+
+    [[nodiscard]] std::span<const std::string_view> positionalViews() const noexcept { return m_positionals; }
+    [[nodiscard]] std::string_view programName() const noexcept { return m_programName; }
+    [[nodiscard]] ParseState state() const noexcept { return m_state; }
+
+    // The subcommand named on the command line and the values parsed for it.
+    [[nodiscard]] std::string_view subcommand() const noexcept { return m_subcommand; }
+    [[nodiscard]] const ParseResult* subcommandResult() const noexcept {
+        return m_subcommand.empty() ? nullptr : m_subcommandResult.get();
+    }
+
+private:
+    friend class ArgParser;
+
+    // Gives a nested result back to the resource it was allocated from.
+    struct NestedDeleter {
+        std::pmr::memory_resource* resource;
+
+        void operator()(ParseResult* result) const;
+    };
+
+    using NestedPtr = std::unique_ptr<ParseResult, NestedDeleter>;
+
+    const ArgParser* m_schema = nullptr;
+    // Mutable because a lazy result fills in environment fallbacks on first read.
+    mutable std::pmr::vector<ArgumentValue> m_values;
+    std::pmr::vector<std::string_view> m_positionals;
+    mutable std::pmr::vector<std::uint32_t> m_touched;
+    // One bit per argument given, matched against the schema's required mask.
+    mutable std::pmr::vector<std::uint64_t> m_setBits;
+    // Arguments a lazy result has already checked.
+    mutable std::pmr::vector<std::uint64_t> m_resolvedBits;
+    std::pmr::vector<MappedFile> m_mappedFiles;
+    std::string_view m_programName;
+    std::string_view m_subcommand;
+    // Kept across clear() so reusing the result also reuses the nested buffers.
+    // Allocated from this result's resource.
+    NestedPtr m_subcommandResult;
+    std::uint64_t m_revision = 0;
+    bool m_lazy = false;
+    ParseState m_state = ParseState::Complete;
+
+    [[nodiscard]] const Argument* find(std::string_view name, const ArgumentValue*& value) const;
+    // The value of argument index, recording its first write for clear() and the required check.
+    [[nodiscard]] ArgumentValue& slot(std::size_t index) const;
+};
+
+template <typename T>
+std::optional<T> ParseResult::get(std::string_view name) const {
+    const ArgumentValue* value = nullptr;
+    const auto* arg = find(name, value);
+
+    if (!arg) {
+
+        return std::nullopt;
+    }
+
+    return value->get<T>(arg->type(), arg->defaultValue());
+}
+
+template <typename T>
+std::vector<T> ParseResult::getAll(std::string_view name) const {
+    const ArgumentValue* value = nullptr;
+    const auto* arg = find(name, value);
+
+    return arg ? value->getAll<T>(arg->defaultValue()) : std::vector<T>{};
+}
+
+}
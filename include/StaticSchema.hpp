@@ -0,0 +1,306 @@
+#pragma once
+
+#include "Converter.hpp"
+#include "Exceptions.hpp"
+#include "TokenSource.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace argparser {
+
+template <std::size_t N>
+struct FixedString {
+    char data[N]{};
+
+    constexpr FixedString(const char (&str)[N]) {
+        std::copy_n(str, N, data);
+    }
+
+    [[nodiscard]] constexpr std::string_view view() const noexcept { return {data, N - 1}; }
+};
+
+template <FixedString LongName, typename T, char ShortName = '\0'>
+struct Opt {
+    using value_type = T;
+
+    static constexpr std::string_view longName = LongName.view();
+    static constexpr char shortName = ShortName;
+    static constexpr bool isFlag = false;
+};
+
+template <FixedString LongName, char ShortName = '\0'>
+struct Flag {
+    using value_type = bool;
+
+    static constexpr std::string_view longName = LongName.view();
+    static constexpr char shortName = ShortName;
+    static constexpr bool isFlag = true;
+};
+
+// Schema fixed at compile time. Names are resolved through a constexpr sorted
+// table and a direct-indexed short name table; typed handles resolve to a
+// tuple index, so get<Spec>() is a plain member load.
+template <typename... Specs>
+class StaticSchema {
+public:
+    static constexpr std::size_t size = sizeof...(Specs);
+
+    template <typename Spec>
+    static consteval std::size_t indexOf() {
+        constexpr bool matches[] = {std::is_same_v<Spec, Specs>...};
+
+        for (std::size_t i = 0; i < size; ++i) {
+
+            if (matches[i]) {
+                return i;
+            }
+        }
+
+        return size;
+    }
+
+    static constexpr std::size_t find(std::string_view longName) noexcept {
+        auto it = std::lower_bound(s_longNames.begin(), s_longNames.end(), longName,
+                                    [](const NameEntry& entry, std::string_view name) {
+                                        return entry.name < name;
+                                    });
+
+        return it != s_longNames.end() && it->name == longName ? it->index : size;
+    }
+
+    static constexpr std::size_t find(char shortName) noexcept {
+        const auto code = static_cast<unsigned char>(shortName);
+
+        return code < s_shortNames.size() ? s_shortNames[code] : size;
+    }
+
+    void parseOptions(int argc, char* argv[]) {
+        ArgvTokenSource source(argc, argv);
+        parseTokens(source);
+    }
+
+    // Each parse starts from the defaults; values and positionals of an
+    // earlier parse are dropped.
+    void parseTokens(TokenSource& source) {
+        reset();
+        std::string_view arg;
+
+        while (source.next(arg)) {
+
+            if (arg.starts_with("--")) {
+                parseLongOption(arg, source);
+
+            } else if (arg.starts_with("-") && arg.length() > 1) {
+                parseShortOption(arg, source);
+
+            } else {
+                m_positionals.push_back(arg);
+            }
+        }
+    }
+
+    template <typename Spec>
+    [[nodiscard]] const typename Spec::value_type& get() const noexcept {
+        return std::get<checkedIndex<Spec>()>(m_values);
+    }
+
+    template <typename Spec>
+    [[nodiscard]] bool isSet() const noexcept {
+        return m_isSet.test(checkedIndex<Spec>());
+    }
+
+    template <typename Spec>
+    StaticSchema& defaultValue(typename Spec::value_type value) {
+        std::get<checkedIndex<Spec>()>(m_values) = value;
+        std::get<checkedIndex<Spec>()>(m_defaults) = std::move(value);
+
+        return *this;
+    }
+
+    // Forgets the values stored by the last parse; the defaults are kept.
+    void reset() {
+        m_values = m_defaults;
+        m_isSet.reset();
+        m_positionals.clear();
+    }
+
+    [[nodiscard]] std::span<const std::string_view> positionalViews() const noexcept {
+        return m_positionals;
+    }
+
+private:
+    struct NameEntry {
+        std::string_view name;
+        std::size_t index = 0;
+    };
+
+    using Setter = bool (*)(StaticSchema&, std::string_view);
+
+    static constexpr std::array<NameEntry, size> s_longNames = [] {
+        std::array<NameEntry, size> table{};
+        std::size_t i = 0;
+        ((table[i] = NameEntry{Specs::longName, i}, ++i), ...);
+
+        std::sort(table.begin(), table.end(), [](const NameEntry& lhs, const NameEntry& rhs) {
+            return lhs.name < rhs.name;
+        });
+
+        return table;
+    }();
+
+    static constexpr std::array<std::size_t, 128> s_shortNames = [] {
+        std::array<std::size_t, 128> table{};
+        table.fill(size);
+        std::size_t i = 0;
+        ((Specs::shortName != '\0' ? (table[static_cast<unsigned char>(Specs::shortName)] = i) : 0, ++i), ...);
+
+        return table;
+    }();
+
+    static constexpr std::array<bool, size> s_isFlag = {Specs::isFlag...};
+
+    static consteval bool hasUniqueNames() {
+
+        for (std::size_t i = 1; i < size; ++i) {
+
+            if (s_longNames[i - 1].name == s_longNames[i].name) {
+                return false;
+            }
+        }
+
+        constexpr char shortNames[] = {Specs::shortName..., '\0'};
+
+        for (std::size_t i = 0; i < size; ++i) {
+
+            for (std::size_t j = i + 1; j < size; ++j) {
+
+                if (shortNames[i] != '\0' && shortNames[i] == shortNames[j]) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    static_assert(hasUniqueNames(), "StaticSchema option names must be unique");
+    static_assert(((static_cast<unsigned char>(Specs::shortName) < 128) && ...),
+                    "StaticSchema short names must be ASCII");
+
+    template <typename Spec>
+    static consteval std::size_t checkedIndex() {
+        constexpr std::size_t index = indexOf<Spec>();
+        static_assert(index < size, "Spec is not part of this StaticSchema");
+
+        return index;
+    }
+
+    template <std::size_t I>
+    static bool setAt(StaticSchema& self, std::string_view value) {
+        using Spec = std::tuple_element_t<I, std::tuple<Specs...>>;
+
+        if constexpr (Spec::isFlag) {
+            std::get<I>(self.m_values) = true;
+        } else {
+            // Converted aside, so a rejected value leaves the previous one in place.
+            typename Spec::value_type converted{};
+
+            if (!convertValue(value, converted)) {
+                return false;
+            }
+            std::get<I>(self.m_values) = std::move(converted);
+        }
+        self.m_isSet.set(I);
+
+        return true;
+    }
+
+    static constexpr std::array<Setter, size> s_setters = []<std::size_t... Is>(std::index_sequence<Is...>) {
+        return std::array<Setter, size>{&setAt<Is>...};
+    }(std::make_index_sequence<size>{});
+
+    void assign(std::size_t index, std::string_view value) {
+
+        if (!s_setters[index](*this, value)) {
+            throw ValidationError("Invalid value for argument:" + std::string(value));
+        }
+    }
+
+    void parseShortOption(std::string_view arg, TokenSource& source) {
+
+        for (std::size_t i = 1; i < arg.length(); ++i) {
+            const auto index = find(arg[i]);
+
+            if (index == size) {
+                throw UnknownArgumentError(std::string(arg));
+            }
+
+            if (s_isFlag[index]) {
+                assign(index, {});
+
+                continue;
+            }
+
+            if (i + 1 < arg.length()) {
+                assign(index, arg.substr(i + 1));
+
+                return;
+            }
+
+            std::string_view value;
+
+            if (!source.next(value)) {
+                throw ParseError("Missing value for option: " + std::string(arg));
+            }
+            assign(index, value);
+
+            return;
+        }
+    }
+
+    void parseLongOption(std::string_view arg, TokenSource& source) {
+        const auto eqPos = arg.find('=');
+        const auto longName = arg.substr(2, eqPos == std::string_view::npos ? std::string_view::npos : eqPos - 2);
+        const auto index = find(longName);
+
+        if (index == size) {
+            throw UnknownArgumentError(std::string(arg));
+        }
+
+        if (s_isFlag[index]) {
+
+            if (eqPos != std::string_view::npos) {
+                throw ParseError("Flag argument cannot have a value: " + std::string(arg));
+            }
+            assign(index, {});
+
+        } else {
+            std::string_view value;
+
+            if (eqPos != std::string_view::npos) {
+                value = arg.substr(eqPos + 1);
+
+            } else if (!source.next(value)) {
+                throw ParseError("Missing value for option: " + std::string(arg));
+            }
+            assign(index, value);
+        }
+    }
+
+    std::tuple<typename Specs::value_type...> m_values{};
+    std::tuple<typename Specs::value_type...> m_defaults{};
+    std::bitset<size> m_isSet;
+    std::vector<std::string_view> m_positionals;
+};
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace argparser {
+
+// Append-only set of distinct strings behind a parser's names and texts. The
+// characters live in an arena that only grows, so every view and id handed
+// out stays valid until the pool is destroyed, also when a text is replaced.
+// A lookup hashes the text once; after that names are plain integer ids.
+class StringPool {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    using Id = std::uint32_t;
+
+    static constexpr Id npos = static_cast<Id>(-1);
+    // The empty string always exists and is never stored.
+    static constexpr Id empty = 0;
+
+    explicit StringPool(const allocator_type& alloc = {});
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // Id of value, copying it into the pool the first time it is seen.
+    Id intern(std::string_view value);
+    [[nodiscard]] std::string_view store(std::string_view value) { return view(intern(value)); }
+
+    // Id of value if it was interned before, npos otherwise.
+    [[nodiscard]] Id find(std::string_view value) const noexcept;
+    [[nodiscard]] std::string_view view(Id id) const noexcept { return m_strings[id]; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_strings.size(); }
+    [[nodiscard]] std::size_t bytes() const noexcept { return m_bytes; }
+
+    // Makes room for strings more entries holding bytes characters in total,
+    // so a schema of known size is interned without growing anything.
+    void reserve(std::size_t strings, std::size_t bytes);
+
+private:
+    std::pmr::monotonic_buffer_resource m_arena;
+    std::pmr::vector<std::string_view> m_strings;
+    std::pmr::vector<std::uint32_t> m_hashes;
+    // Open addressing over the ids, at most half full.
+    std::pmr::vector<Id> m_slots;
+    std::size_t m_bytes = 0;
+    // Characters left in the block reserve() set aside.
+    char* m_reserved = nullptr;
+    std::size_t m_reservedBytes = 0;
+
+    [[nodiscard]] static std::uint32_t hash(std::string_view value) noexcept;
+    [[nodiscard]] std::size_t slotOf(std::string_view value, std::uint32_t hashed) const noexcept;
+    void rehash(std::size_t slots);
+    [[nodiscard]] char* allocate(std::size_t length);
+};
+
+}
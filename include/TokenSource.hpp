@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace argparser {
+
+// Forward-only stream of command line tokens. The views handed out must stay
+// valid for as long as the parse results that reference them are in use.
+class TokenSource {
+public:
+    virtual ~TokenSource() = default;
+
+    [[nodiscard]] virtual bool next(std::string_view& token) = 0;
+};
+
+class ArgvTokenSource final : public TokenSource {
+public:
+    ArgvTokenSource(int argc, const char* const* argv, int first = 1) noexcept
+        : m_argv(argv), m_index(first), m_argc(argc) {}
+
+    [[nodiscard]] bool next(std::string_view& token) override {
+
+        if (m_index >= m_argc) {
+            return false;
+        }
+        token = m_argv[m_index++];
+
+        return true;
+    }
+
+private:
+    const char* const* m_argv;
+    int m_index;
+    int m_argc;
+};
+
+template <typename Iterator>
+class RangeTokenSource final : public TokenSource {
+public:
+    RangeTokenSource(Iterator first, Iterator last)
+        : m_current(first), m_last(last) {}
+
+    [[nodiscard]] bool next(std::string_view& token) override {
+
+        if (m_current == m_last) {
+            return false;
+        }
+        token = *m_current++;
+
+        return true;
+    }
+
+private:
+    Iterator m_current;
+    Iterator m_last;
+};
+
+// Splits the contents of a response file into whitespace separated tokens
+// while the parser asks for them. A token that starts with a single or double
+// quote runs up to the matching quote, so it may contain whitespace; quotes
+// anywhere else are taken literally. Tokens are views into the contents.
+class ResponseFileTokenSource final : public TokenSource {
+public:
+    explicit ResponseFileTokenSource(std::string_view contents = {}) noexcept
+        : m_contents(contents) {}
+
+    [[nodiscard]] bool next(std::string_view& token) override {
+        std::size_t pos = m_position;
+
+        while (pos < m_contents.size() && isSpace(m_contents[pos])) {
+            ++pos;
+        }
+
+        if (pos == m_contents.size()) {
+            m_position = pos;
+
+            return false;
+        }
+
+        const char quote = m_contents[pos];
+
+        if (quote == '"' || quote == '\'') {
+            const auto close = m_contents.find(quote, pos + 1);
+            const auto last = close == std::string_view::npos ? m_contents.size() : close;
+            token = m_contents.substr(pos + 1, last - pos - 1);
+            m_position = close == std::string_view::npos ? last : last + 1;
+
+            return true;
+        }
+
+        std::size_t last = pos;
+
+        while (last < m_contents.size() && !isSpace(m_contents[last])) {
+            ++last;
+        }
+        token = m_contents.substr(pos, last - pos);
+        m_position = last;
+
+        return true;
+    }
+
+private:
+    std::string_view m_contents;
+    std::size_t m_position = 0;
+
+    [[nodiscard]] static constexpr bool isSpace(char c) noexcept {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+};
+
+}
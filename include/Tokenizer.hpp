@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace argparser {
+
+enum class TokenKind : std::uint8_t {
+    Positional,
+    Short,
+    Long
+};
+
+// One classified command line token. For long options key and value are the
+// parts around the first '='; for short options key is everything after '-'.
+struct Token {
+    TokenKind kind = TokenKind::Positional;
+    std::string_view key;
+    std::string_view value;
+    bool hasValue = false;
+};
+
+// Position of the first '=' in text, or std::string_view::npos. Scans 16 bytes
+// at a time with SSE2 or NEON where available and falls back to a plain loop.
+[[nodiscard]] std::size_t findEquals(std::string_view text) noexcept;
+
+// Classifies arg as "--key[=value]", "-abc" or a positional, without copying.
+[[nodiscard]] Token splitToken(std::string_view arg) noexcept;
+
+}
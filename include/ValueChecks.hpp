@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace argparser {
+
+// Built-in checks stored inline in an Argument and run on the string_view, so
+// checking a value needs no std::function call and no std::string. Choices and
+// the pattern are copied into the argument's resource when they are set.
+class ValueChecks {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    explicit ValueChecks(const allocator_type& alloc = {}) : m_choices(alloc), m_pattern(alloc) {}
+
+    // Value must be a number within [min, max].
+    void range(double min, double max) noexcept;
+    void length(std::size_t min, std::size_t max) noexcept;
+    void choices(std::initializer_list<std::string_view> values);
+    // ECMAScript regex the whole value has to match; compiled by compile().
+    void pattern(std::string_view regex);
+    // Opt-in, since it asks the filesystem about every value.
+    void pathExists(bool enabled) noexcept;
+
+    // Compiles the pattern once, also when reached from several threads.
+    // Throws ArgumentError for an invalid pattern.
+    void compile() const;
+
+    [[nodiscard]] bool empty() const noexcept { return m_kinds == 0; }
+    // Runs compile() first if the schema was never frozen.
+    [[nodiscard]] bool accepts(std::string_view value) const;
+
+private:
+    enum Kind : std::uint8_t {
+        Range = 1 << 0,
+        Length = 1 << 1,
+        Choices = 1 << 2,
+        Pattern = 1 << 3,
+        PathExists = 1 << 4
+    };
+
+    // The holder comes from the argument's resource; std::regex itself has no
+    // allocator support and builds its automaton on the global heap.
+    struct CompiledPattern {
+        std::once_flag once;
+        std::optional<std::regex> regex;
+    };
+
+    struct PatternDeleter {
+        std::pmr::memory_resource* resource;
+
+        void operator()(CompiledPattern* pattern) const {
+            allocator_type(resource).delete_object(pattern);
+        }
+    };
+
+    std::uint8_t m_kinds = 0;
+    double m_min = 0;
+    double m_max = 0;
+    std::size_t m_minLength = 0;
+    std::size_t m_maxLength = 0;
+    std::pmr::vector<std::pmr::string> m_choices;
+    std::pmr::string m_pattern;
+    std::unique_ptr<CompiledPattern, PatternDeleter> m_compiled;
+};
+
+}
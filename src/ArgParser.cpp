@@ -0,0 +1,1778 @@
+#include "ArgParser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <stdlib.h>
+#define ARGPARSER_ENVIRON _environ
+#else
+#include <unistd.h>
+extern "C" char** environ;
+#define ARGPARSER_ENVIRON environ
+#endif
+
+namespace argparser {
+
+namespace {
+
+// Length of the help label "-s, --long" (or the positional name) without building it.
+std::size_t labelWidth(const Argument& arg) noexcept {
+
+    if (arg.type() == ArgumentType::Positional) {
+        return arg.name().length();
+    }
+
+    const auto shortName = arg.shortName().length();
+    const auto longName = arg.longName().length();
+
+    return (shortName ? shortName + 1 : 0) + (shortName && longName ? 2 : 0) + (longName ? longName + 2 : 0);
+}
+
+template <typename String>
+std::size_t appendOptionLabel(String& out, const Argument& arg) {
+    const auto start = out.length();
+
+    if (!arg.shortName().empty()) {
+        out.append("-").append(arg.shortName());
+    }
+
+    if (!arg.longName().empty()) {
+
+        if (out.length() != start) {
+            out.append(", ");
+        }
+        out.append("--").append(arg.longName());
+    }
+
+    return out.length() - start;
+}
+
+}
+
+ArgParser::ArgParser(std::string_view programName, std::string_view description,
+                    std::pmr::memory_resource* resource)
+    : m_resource(resource),
+    m_table(get_allocator().new_object<ArgumentTable>(), ResourceDeleter<ArgumentTable>{resource}),
+    m_helpCache(get_allocator().new_object<HelpCache>(), ResourceDeleter<HelpCache>{resource}),
+    m_strings(get_allocator().new_object<StringPool>(), ResourceDeleter<StringPool>{resource}),
+    m_programName(m_strings->store(programName)), m_description(m_strings->store(description)),
+    m_arguments(resource), m_argumentsById(resource), m_positionalViews(resource),
+    m_ownedTokens(get_allocator().new_object<TokenStore>(), ResourceDeleter<TokenStore>{resource}), m_mappedFiles(resource), m_configFiles(resource), m_config(resource),
+    m_subcommands(resource), m_subcommandMap(resource) {}
+
+template <typename... Args>
+Argument& ArgParser::emplaceArgument(Args&&... args) {
+    ArgumentPtr arg(get_allocator().new_object<Argument>(*m_strings, std::forward<Args>(args)...),
+                    ResourceDeleter<Argument>{m_resource});
+    auto* argPtr = arg.get();
+    argPtr->m_index = m_arguments.size();
+    argPtr->m_table = m_table.get();
+    m_table->add(argPtr->type(), argPtr->isRequired(), labelWidth(*argPtr));
+
+    m_arguments.push_back(std::move(arg));
+
+    return *argPtr;
+}
+
+void ArgParser::mapName(std::string_view name, Argument* arg) {
+
+    if (!name.empty()) {
+        const auto id = m_strings->intern(name);
+
+        if (id >= m_argumentsById.size()) {
+            m_argumentsById.resize(id + 1, ArgumentTable::npos);
+        }
+        m_argumentsById[id] = static_cast<std::uint32_t>(arg->index());
+    }
+}
+
+void ArgParser::mapShortName(std::string_view name, Argument* arg) {
+    mapName(name, arg);
+
+    if (name.length() == 1) {
+        m_table->setShortName(name.front(), arg->index());
+    }
+}
+
+void ArgParser::mapLongName(std::string_view name, Argument* arg) {
+    mapName(name, arg);
+
+    if (!name.empty()) {
+        m_table->addLongName(arg->longName(), arg->index());
+    }
+}
+
+Argument& ArgParser::addFlag(std::string_view shortName, std::string_view longName,
+                    std::string_view description) {
+    auto& arg = emplaceArgument(shortName, longName, description);
+
+    mapShortName(shortName, &arg);
+    mapLongName(longName, &arg);
+
+    return arg;
+}
+
+Argument& ArgParser::addOption(std::string_view shortName, std::string_view longName,
+                    std::string_view description,
+                    std::string_view defaultValue) {
+    auto& arg = emplaceArgument(shortName, longName, description, defaultValue);
+
+    mapShortName(shortName, &arg);
+    mapLongName(longName, &arg);
+
+    return arg;
+}
+
+Argument& ArgParser::addPositional(std::string_view name,std::string_view description,
+                                    bool required ) {
+    auto& arg = emplaceArgument(name, description, required);
+
+    mapName(name, &arg);
+
+    return arg;
+}
+
+ArgParser& ArgParser::addSubcommand(std::string_view name, SubcommandFactory factory,
+                                    std::string_view description) {
+
+    if (name.empty() || m_subcommandMap.contains(name)) {
+        throw ArgumentError("Invalid or duplicate subcommand: " + std::string(name));
+    }
+
+    auto* resource = m_resource;
+    SubcommandPtr subcommand(get_allocator().new_object<Subcommand>(name, description, std::move(factory), resource),
+                            ResourceDeleter<Subcommand>{resource});
+
+    m_subcommandMap.emplace(subcommand->name, subcommand.get());
+    m_subcommands.push_back(std::move(subcommand));
+    m_table->touch();
+
+    return *this;
+}
+
+const ArgParser* ArgParser::subcommandParser(std::string_view name) const {
+    auto it = m_subcommandMap.find(name);
+
+    return it != m_subcommandMap.end() ? it->second->parser.get() : nullptr;
+}
+
+ArgParser& ArgParser::buildSubcommand(Subcommand& subcommand) const {
+
+    std::call_once(subcommand.built, [this, &subcommand] {
+        auto* resource = m_resource;
+        std::pmr::string name(m_programName, resource);
+
+        if (!name.empty()) {
+            name.append(" ");
+        }
+        name.append(subcommand.name);
+
+        // ArgParser takes a memory_resource*, so it cannot go through new_object.
+        allocator_type alloc(resource);
+        auto* memory = alloc.allocate_object<ArgParser>();
+
+        try {
+            ::new (memory) ArgParser(name, subcommand.description, resource);
+        } catch (...) {
+            alloc.deallocate_object(memory);
+            throw;
+        }
+
+        std::unique_ptr<ArgParser, ResourceDeleter<ArgParser>> parser(memory, ResourceDeleter<ArgParser>{resource});
+        parser->m_exitOnHelp = m_exitOnHelp;
+        parser->m_output = m_output;
+        subcommand.factory(*parser);
+        parser->freeze();
+        subcommand.parser = std::move(parser);
+    });
+
+    return *subcommand.parser;
+}
+
+// Numbers the tokens handed to the parse loop and, when given somewhere to keep
+// the mappings, expands @path tokens into the contents of that response file.
+class ArgParser::TokenCursor {
+public:
+    static constexpr std::size_t maxResponseFileDepth = 16;
+
+    explicit TokenCursor(TokenSource& source, std::pmr::vector<MappedFile>* mappedFiles = nullptr) noexcept
+        : m_source(source), m_mappedFiles(mappedFiles) {}
+
+    [[nodiscard]] bool next(std::string_view& token) {
+
+        while (true) {
+            auto& source = m_depth > 0 ? static_cast<TokenSource&>(m_files[m_depth - 1]) : m_source;
+
+            if (!source.next(token)) {
+
+                if (m_depth == 0) {
+                    return false;
+                }
+                --m_depth;
+
+                continue;
+            }
+
+            if (!m_mappedFiles || token.length() < 2 || token.front() != '@') {
+                ++m_index;
+
+                return true;
+            }
+
+            if (!expand(token)) {
+                return false;
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t index() const noexcept { return m_index - 1; }
+    [[nodiscard]] std::size_t count() const noexcept { return m_index; }
+
+    [[nodiscard]] const std::optional<ParseErrorInfo>& error() const noexcept { return m_error; }
+
+private:
+    TokenSource& m_source;
+    std::pmr::vector<MappedFile>* m_mappedFiles;
+    std::array<ResponseFileTokenSource, maxResponseFileDepth> m_files;
+    std::size_t m_depth = 0;
+    std::size_t m_index = 0;
+    std::optional<ParseErrorInfo> m_error;
+
+    [[nodiscard]] bool expand(std::string_view token) {
+        std::optional<MappedFile> file;
+
+        if (m_depth < m_files.size()) {
+            file = MappedFile::open(std::string(token.substr(1)));
+        }
+
+        if (!file) {
+            m_error = ParseErrorInfo{ParseErrorCode::InvalidResponseFile, m_index, token, {}};
+
+            return false;
+        }
+
+        m_mappedFiles->push_back(std::move(*file));
+        m_files[m_depth++] = ResponseFileTokenSource(m_mappedFiles->back().contents());
+
+        return true;
+    }
+};
+
+#if ARGPARSER_INSTRUMENTATION
+
+// Collects the ParseStats of one parse and hands them to the observer. Without
+// an observer every hook is a single branch.
+class ArgParser::ParseProbe {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    ParseProbe(ParseObserver* observer, std::pmr::memory_resource* schema,
+                std::pmr::memory_resource* result = nullptr)
+        : m_observer(observer) {
+
+        if (!m_observer) {
+            return;
+        }
+
+        watch(0, schema);
+
+        if (result != schema) {
+            watch(1, result);
+        }
+        m_start = Clock::now();
+    }
+
+    template <typename Function>
+    auto measure(ParsePhase phase, Function&& function) {
+
+        if (!m_observer) {
+            return function();
+        }
+
+        const auto start = Clock::now();
+        auto result = function();
+        m_stats.phases[static_cast<std::size_t>(phase)] += elapsedSince(start);
+
+        return result;
+    }
+
+    template <typename Function>
+    auto lookup(Function&& function) {
+
+        if (m_observer) {
+            ++m_stats.lookups;
+        }
+
+        return measure(ParsePhase::Lookup, std::forward<Function>(function));
+    }
+
+    [[nodiscard]] bool accepts(const Argument& argument, std::string_view value) {
+
+        if (!m_observer || !argument.hasValidator()) {
+            return argument.accepts(value);
+        }
+
+        m_observer->onValidatorBegin(argument);
+        const auto start = Clock::now();
+        const bool accepted = argument.accepts(value);
+        const auto elapsed = elapsedSince(start);
+
+        m_stats.phases[static_cast<std::size_t>(ParsePhase::Validate)] += elapsed;
+        ++m_stats.validatorCalls;
+        m_observer->onValidatorEnd(argument, value, elapsed);
+
+        if (elapsed >= m_observer->slowValidatorThreshold()) {
+            ++m_stats.slowValidators;
+            m_observer->onSlowValidator(argument, value, elapsed);
+        }
+
+        return accepted;
+    }
+
+    void finish(std::size_t tokens, bool failed) {
+
+        if (!m_observer) {
+            return;
+        }
+
+        m_stats.total = elapsedSince(m_start);
+        m_stats.tokens = tokens;
+        m_stats.failed = failed;
+
+        for (std::size_t i = 0; i < m_counters.size(); ++i) {
+
+            if (m_counters[i]) {
+                m_stats.allocations += m_counters[i]->allocations() - m_baseline[i];
+            }
+        }
+
+        m_observer->onParse(m_stats);
+    }
+
+private:
+    ParseObserver* m_observer;
+    Clock::time_point m_start;
+    ParseStats m_stats;
+    std::array<const CountingResource*, 2> m_counters{};
+    std::array<std::size_t, 2> m_baseline{};
+
+    [[nodiscard]] static std::chrono::nanoseconds elapsedSince(Clock::time_point start) noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    }
+
+    void watch(std::size_t slot, std::pmr::memory_resource* resource) {
+        m_counters[slot] = dynamic_cast<const CountingResource*>(resource);
+
+        if (m_counters[slot]) {
+            m_baseline[slot] = m_counters[slot]->allocations();
+        }
+    }
+};
+
+#else
+
+class ArgParser::ParseProbe {
+public:
+    ParseProbe(ParseObserver*, std::pmr::memory_resource*, std::pmr::memory_resource* = nullptr) noexcept {}
+
+    template <typename Function>
+    auto measure(ParsePhase, Function&& function) { return function(); }
+
+    template <typename Function>
+    auto lookup(Function&& function) { return function(); }
+
+    [[nodiscard]] bool accepts(const Argument& argument, std::string_view value) const {
+        return argument.accepts(value);
+    }
+
+    void finish(std::size_t, bool) const noexcept {}
+};
+
+#endif
+
+// Writes parse results into the Argument objects and the parser itself.
+class ArgParser::ArgumentStore {
+public:
+    ArgumentStore(ArgParser& parser, ParseProbe& probe) noexcept
+        : m_parser(parser), m_probe(probe), m_deferred(parser.m_deferValidation) {}
+
+    [[nodiscard]] ParseProbe& probe() noexcept { return m_probe; }
+    [[nodiscard]] bool environment() const noexcept { return true; }
+    [[nodiscard]] bool config() const noexcept { return true; }
+    [[nodiscard]] bool lazy() const noexcept { return false; }
+    [[nodiscard]] bool prints() const noexcept { return true; }
+    [[nodiscard]] ParseState state() const noexcept { return m_parser.m_state; }
+    void setState(ParseState state) noexcept { m_parser.m_state = state; }
+
+    [[nodiscard]] bool check(const Argument& arg, std::string_view value) {
+        return m_deferred || m_probe.accepts(arg, value);
+    }
+
+    [[nodiscard]] bool setValue(Argument& arg, std::string_view value) {
+
+        if (arg.type() == ArgumentType::Flag || !check(arg, value)) {
+            return false;
+        }
+        return arg.store(value, false);
+    }
+
+    [[nodiscard]] bool setOwnedValue(Argument& arg, std::string_view value) {
+
+        if (arg.type() == ArgumentType::Flag || !check(arg, value)) {
+            return false;
+        }
+        return arg.store(value, true);
+    }
+
+    void setFlag(Argument& arg) { arg.setFlag(true); }
+
+    [[nodiscard]] bool isSet(std::size_t index) const noexcept {
+        return m_parser.m_arguments[index]->isSet();
+    }
+
+    [[nodiscard]] std::span<const std::string_view> values(std::size_t index) const noexcept {
+        return m_parser.m_arguments[index]->values();
+    }
+
+    [[nodiscard]] std::uint32_t missingRequired() const noexcept {
+
+        for (const auto index : m_parser.m_table->required()) {
+
+            if (!isSet(index)) {
+                return index;
+            }
+        }
+
+        return ArgumentTable::npos;
+    }
+
+    void addPositional(std::string_view value) { m_parser.m_positionalViews.push_back(value); }
+
+    [[nodiscard]] std::span<const std::string_view> positionals() const noexcept {
+        return m_parser.m_positionalViews;
+    }
+
+    [[nodiscard]] std::optional<ParseErrorInfo> parseSubcommand(std::string_view name, ArgParser& parser,
+                                                                TokenCursor& cursor) {
+        m_parser.m_selectedSubcommand = name;
+        parser.m_state = ParseState::Complete;
+        ArgumentStore store(parser, m_probe);
+        auto error = parser.parseTokens(cursor, store);
+        m_parser.m_state = parser.m_state;
+
+        return error;
+    }
+
+private:
+    ArgParser& m_parser;
+    ParseProbe& m_probe;
+    bool m_deferred;
+};
+
+// Writes parse results into a ParseResult, leaving the schema untouched.
+class ArgParser::ResultStore {
+public:
+    ResultStore(ParseResult& result, ParseProbe& probe, bool deferred, bool environment = true) noexcept
+        : m_result(result), m_probe(probe), m_deferred(deferred), m_environment(environment) {}
+
+    [[nodiscard]] ParseProbe& probe() noexcept { return m_probe; }
+    // A lazy result reads the environment only for the arguments asked for.
+    [[nodiscard]] bool environment() const noexcept { return m_environment && !m_result.m_lazy; }
+    // The loaded config is read-only and owned by the parser, so batch rows take it as well.
+    [[nodiscard]] bool config() const noexcept { return !m_result.m_lazy; }
+    [[nodiscard]] bool lazy() const noexcept { return m_result.m_lazy; }
+    // Batch rows neither read the process environment nor print.
+    [[nodiscard]] bool prints() const noexcept { return m_environment; }
+    [[nodiscard]] ParseState state() const noexcept { return m_result.m_state; }
+    void setState(ParseState state) noexcept { m_result.m_state = state; }
+
+    [[nodiscard]] bool check(const Argument& arg, std::string_view value) {
+        return m_deferred || m_result.m_lazy || m_probe.accepts(arg, value);
+    }
+
+    [[nodiscard]] bool setValue(const Argument& arg, std::string_view value) {
+
+        if (arg.type() == ArgumentType::Flag || !check(arg, value)) {
+            return false;
+        }
+        return store(arg, value, false);
+    }
+
+    [[nodiscard]] bool setOwnedValue(const Argument& arg, std::string_view value) {
+
+        if (arg.type() == ArgumentType::Flag || !check(arg, value)) {
+            return false;
+        }
+
+        return store(arg, value, true);
+    }
+
+    void setFlag(const Argument& arg) {
+        slot(arg).setFlag(true);
+        (void)arg.writeBound("true");
+    }
+
+    [[nodiscard]] bool store(const Argument& arg, std::string_view value, bool owned) {
+        auto& stored = slot(arg);
+
+        if (arg.isMultiValue()) {
+            stored.append(value, owned);
+        } else {
+            stored.assign(value, owned);
+        }
+
+        return arg.writeBound(stored.values().back());
+    }
+
+    [[nodiscard]] bool isSet(std::size_t index) const noexcept {
+        return m_result.m_values[index].isSet();
+    }
+
+    [[nodiscard]] std::span<const std::string_view> values(std::size_t index) const noexcept {
+        return m_result.m_values[index].values();
+    }
+
+    // First required argument whose bit is missing from the set mask. A lazy
+    // parse skipped the environment, so it is consulted for those arguments only.
+    [[nodiscard]] std::uint32_t missingRequired() const {
+        const auto& parser = *m_result.m_schema;
+        const auto required = parser.m_table->requiredMask();
+
+        for (std::size_t word = 0; word < required.size(); ++word) {
+            auto missing = required[word] & ~m_result.m_setBits[word];
+
+            while (missing != 0) {
+                const auto index = static_cast<std::uint32_t>(word * 64 + std::countr_zero(missing));
+                missing &= missing - 1;
+
+                if (!m_result.m_lazy || !parser.applyLazyFallback(m_result, *parser.m_arguments[index])) {
+                    return index;
+                }
+            }
+        }
+
+        return ArgumentTable::npos;
+    }
+
+    void addPositional(std::string_view value) { m_result.m_positionals.push_back(value); }
+
+    [[nodiscard]] std::span<const std::string_view> positionals() const noexcept {
+        return m_result.m_positionals;
+    }
+
+    [[nodiscard]] std::optional<ParseErrorInfo> parseSubcommand(std::string_view name, const ArgParser& parser,
+                                                                TokenCursor& cursor) {
+        auto& nested = m_result.m_subcommandResult;
+
+        if (!nested) {
+            const auto resource = m_result.m_values.get_allocator().resource();
+            nested = ParseResult::NestedPtr(allocator_type(resource).new_object<ParseResult>(resource),
+                                            ParseResult::NestedDeleter{resource});
+        }
+
+        m_result.m_subcommand = name;
+        parser.prepareResult(*nested);
+        nested->m_lazy = nested->m_lazy && m_environment;
+        nested->m_programName = parser.m_programName;
+        ResultStore store(*nested, m_probe, parser.m_deferValidation, m_environment);
+        auto error = parser.parseTokens(cursor, store);
+        m_result.m_state = nested->m_state;
+
+        return error;
+    }
+
+private:
+    ParseResult& m_result;
+    ParseProbe& m_probe;
+    bool m_deferred;
+    bool m_environment;
+
+    ArgumentValue& slot(const Argument& arg) { return m_result.slot(arg.index()); }
+};
+
+void ArgParser::parseOptions(int argc, char* argv[]) {
+
+    if (auto error = tryParse(argc, argv)) {
+        error->raise();
+    }
+}
+
+void ArgParser::parsePositionalOption(const std::vector<std::string>& args) {
+    const auto first = m_ownedTokens->size();
+    m_ownedTokens->insert(m_ownedTokens->end(), args.begin(), args.end());
+
+    RangeTokenSource source(m_ownedTokens->cbegin() + static_cast<std::ptrdiff_t>(first),
+                            m_ownedTokens->cend());
+
+    if (auto error = tryParse(source)) {
+        error->raise();
+    }
+}
+
+std::optional<ParseErrorInfo> ArgParser::tryParse(int argc, char* argv[]) {
+
+    if (m_programName.empty() && argc > 0) {
+        m_programName = m_strings->store(argv[0]);
+        m_table->touch();
+    }
+
+    if (argc > 1 && !m_positionalSink) {
+        m_positionalViews.reserve(m_positionalViews.size() + static_cast<std::size_t>(argc - 1));
+    }
+
+    ArgvTokenSource source(argc, argv);
+
+    return tryParse(source);
+}
+
+std::optional<ParseErrorInfo> ArgParser::tryParse(TokenSource& source) {
+    freeze();
+    m_state = ParseState::Complete;
+    TokenCursor cursor(source, m_responseFiles ? &m_mappedFiles : nullptr);
+    ParseProbe probe(m_observer, m_resource);
+    ArgumentStore store(*this, probe);
+    auto error = parseTokens(cursor, store);
+    probe.finish(cursor.count(), error.has_value());
+
+    return error;
+}
+
+void ArgParser::parseOptions(int argc, char* argv[], ParseResult& result) const {
+
+    if (auto error = tryParse(argc, argv, result)) {
+        error->raise();
+    }
+}
+
+std::optional<ParseErrorInfo> ArgParser::tryParse(int argc, char* argv[], ParseResult& result) const {
+    ArgvTokenSource source(argc, argv);
+    auto error = tryParse(source, result);
+
+    if (argc > 0) {
+        result.m_programName = argv[0];
+    }
+
+    return error;
+}
+
+std::optional<ParseErrorInfo> ArgParser::tryParse(TokenSource& source, ParseResult& result) const {
+    prepareResult(result);
+
+    TokenCursor cursor(source, m_responseFiles ? &result.m_mappedFiles : nullptr);
+    ParseProbe probe(m_observer, m_resource, result.m_values.get_allocator().resource());
+    ResultStore store(result, probe, m_deferValidation);
+    auto error = parseTokens(cursor, store);
+    probe.finish(cursor.count(), error.has_value());
+
+    return error;
+}
+
+void ArgParser::parseBatch(std::span<const CommandLine> lines, Executor& executor, BatchResult& result) const {
+
+    if (!m_table->bound().empty()) {
+        throw ArgumentError("parseBatch() does not support bound arguments");
+    }
+
+    const auto rows = lines.size();
+    const auto columns = m_arguments.size();
+    result.m_schema = this;
+    result.m_rows = rows;
+    result.m_columns = columns;
+    // Every cell is written by the tasks below, so old contents need no clearing.
+    result.m_values.resize(rows * columns);
+    result.m_counts.resize(rows * columns);
+    result.m_subcommands.resize(rows);
+    result.m_states.resize(rows);
+    result.m_errors.clear();
+
+    // Rows are handed out in chunks, so a task that hits slow rows does not
+    // hold up the others.
+    constexpr std::size_t chunkRows = 64;
+    const auto chunks = (rows + chunkRows - 1) / chunkRows;
+    const auto tasks = std::min(std::max<std::size_t>(executor.concurrency(), 1), chunks);
+
+    while (result.m_slabs.size() < tasks) {
+        result.m_slabs.emplace_back(result.m_values.get_allocator().resource());
+    }
+
+    std::atomic<std::size_t> nextChunk{0};
+
+    executor.run(tasks, [&](std::size_t task) {
+        auto& slab = result.m_slabs[task];
+        slab.errors.clear();
+
+        for (auto chunk = nextChunk.fetch_add(1, std::memory_order_relaxed); chunk < chunks;
+                chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) {
+            const auto first = chunk * chunkRows;
+            const auto last = std::min(first + chunkRows, rows);
+
+            for (std::size_t column = 0; column < columns; ++column) {
+                const auto& arg = *m_arguments[column];
+                const auto cells = column * rows;
+                const auto fallback = arg.type() == ArgumentType::Flag ? std::string_view("false") : arg.defaultValue();
+
+                std::fill(result.m_values.begin() + cells + first, result.m_values.begin() + cells + last, fallback);
+                std::fill(result.m_counts.begin() + cells + first, result.m_counts.begin() + cells + last, 0);
+            }
+
+            for (auto row = first; row < last; ++row) {
+
+                if (auto error = parseBatchRow(lines[row], row, slab.result, result)) {
+                    slab.errors.push_back(BatchError{row, *error});
+                }
+            }
+        }
+    });
+
+    for (std::size_t task = 0; task < tasks; ++task) {
+        const auto& errors = result.m_slabs[task].errors;
+        result.m_errors.insert(result.m_errors.end(), errors.begin(), errors.end());
+    }
+
+    std::sort(result.m_errors.begin(), result.m_errors.end(),
+                [](const BatchError& lhs, const BatchError& rhs) { return lhs.row < rhs.row; });
+}
+
+BatchResult ArgParser::parseBatch(std::span<const CommandLine> lines, Executor& executor) const {
+    BatchResult result(m_resource);
+    parseBatch(lines, executor, result);
+
+    return result;
+}
+
+std::optional<ParseErrorInfo> ArgParser::parseBatchRow(const CommandLine& line, std::size_t row,
+                                                        ParseResult& slab, BatchResult& out) const {
+    prepareResult(slab);
+    // The rows' values are copied out unread, so they are always checked while parsing.
+    slab.m_lazy = false;
+
+    RangeTokenSource source(line.arguments.begin(), line.arguments.end());
+    TokenCursor cursor(source, nullptr);
+    ParseProbe probe(m_observer, m_resource, slab.m_values.get_allocator().resource());
+    ResultStore store(slab, probe, m_deferValidation, false);
+    auto error = parseTokens(cursor, store);
+    probe.finish(cursor.count(), error.has_value());
+
+    if (error) {
+        out.m_states[row] = RowState::Error;
+        out.m_subcommands[row] = {};
+
+        return error;
+    }
+
+    if (slab.m_state != ParseState::Complete) {
+        out.m_states[row] = slab.m_state == ParseState::HelpRequested ? RowState::HelpRequested
+                                                                        : RowState::VersionRequested;
+        out.m_subcommands[row] = {};
+
+        return std::nullopt;
+    }
+
+    out.m_states[row] = RowState::Ok;
+    out.m_subcommands[row] = slab.m_subcommand;
+
+    // The row's cells already hold the defaults; only overwrite what was given.
+    for (const auto column : slab.m_touched) {
+        const auto& value = slab.m_values[column];
+        const auto cell = column * out.m_rows + row;
+
+        out.m_values[cell] = m_arguments[column]->type() == ArgumentType::Flag ? std::string_view("true")
+                                                                                : value.values().back();
+        out.m_counts[cell] = static_cast<std::uint32_t>(value.count());
+    }
+
+    return std::nullopt;
+}
+
+void ArgParser::prepareResult(ParseResult& result) const {
+
+    if (m_lazy && !m_table->bound().empty()) {
+        throw ArgumentError("lazy() does not support bound arguments");
+    }
+
+    if (result.m_schema != this || result.m_revision != m_table->revision() ||
+        result.m_values.size() != m_arguments.size()) {
+        const auto words = (m_arguments.size() + 63) / 64;
+        result.m_values.assign(m_arguments.size(), ArgumentValue{});
+        result.m_touched.clear();
+        result.m_setBits.assign(words, 0);
+        result.m_resolvedBits.assign(words, 0);
+        result.m_schema = this;
+        result.m_revision = m_table->revision();
+    }
+    result.clear();
+    result.m_lazy = m_lazy;
+}
+
+void ArgParser::reset() {
+
+    for (const auto& arg : m_arguments) {
+        arg->m_value.clear();
+    }
+
+    m_positionalViews.clear();
+    m_positionalValues.clear();
+    m_ownedTokens->clear();
+    m_mappedFiles.clear();
+    m_selectedSubcommand = {};
+    m_state = ParseState::Complete;
+
+    for (const auto& subcommand : m_subcommands) {
+
+        if (subcommand->parser) {
+            subcommand->parser->reset();
+        }
+    }
+}
+
+template <typename Store>
+std::optional<ParseErrorInfo> ArgParser::parseTokens(TokenCursor& cursor, Store& store) const {
+    const auto declaredPositionals = m_table->positionals().size();
+    std::string_view arg;
+    Token token;
+
+    auto next = [&cursor, &arg, &token] {
+
+        if (!cursor.next(arg)) {
+            return false;
+        }
+        token = splitToken(arg);
+
+        return true;
+    };
+
+    while (store.probe().measure(ParsePhase::Tokenize, next)) {
+
+        if (arg == "--help" || arg == "-h") {
+            return stopForHelp(store, ParseState::HelpRequested);
+        }
+
+        if (arg == "--version" && !m_version.empty() && !findArgument("version")) {
+            return stopForHelp(store, ParseState::VersionRequested);
+        }
+
+        std::optional<ParseErrorInfo> error;
+
+        if (token.kind == TokenKind::Long) {
+            error = parseLongOption(arg, token, cursor, store);
+
+        } else if (token.kind == TokenKind::Short) {
+            error = parseShortOption(arg, cursor, store);
+        
+        } else if (auto it = m_subcommandMap.find(arg); it != m_subcommandMap.end()) {
+            // The sub-parser drains the cursor, so this is the last token seen here.
+            error = store.parseSubcommand(it->second->name, buildSubcommand(*it->second), cursor);
+
+            if (!error && store.state() != ParseState::Complete) {
+                return std::nullopt;
+            }
+
+        } else if (m_positionalSink && store.positionals().size() >= declaredPositionals) {
+            m_positionalSink(arg);
+
+        } else {
+            store.addPositional(arg);
+        }
+
+        if (error) {
+            return cursor.error() ? cursor.error() : error;
+        }
+    }
+
+    if (cursor.error()) {
+        return cursor.error();
+    }
+
+    const auto positionals = store.positionals();
+    const auto positionalArgs = m_table->positionals();
+    const auto assigned = std::min(positionals.size(), positionalArgs.size());
+
+    for (std::size_t i = 0; i < assigned; ++i) {
+        auto& arg = *m_arguments[positionalArgs[i]];
+        const auto value = positionals[i];
+
+        if (!store.setValue(arg, value)) {
+            return ParseErrorInfo{ParseErrorCode::InvalidValue, ParseErrorInfo::npos,
+                                    value, value, &arg};
+        }
+    }
+
+    if (store.config()) {
+
+        auto fallbacks = [&] {
+            auto error = store.environment() ? applyEnvironment(store) : std::optional<ParseErrorInfo>();
+
+            return error ? error : applyConfig(store);
+        };
+
+        if (auto error = store.probe().measure(ParsePhase::Environment, fallbacks)) {
+            return error;
+        }
+    }
+
+    if (m_deferValidation && !store.lazy()) {
+
+        if (auto error = validateDeferred(store)) {
+            return error;
+        }
+    }
+
+    for (const auto index : m_table->bound()) {
+        const auto& argument = *m_arguments[index];
+
+        if (store.isSet(index)) {
+            continue;
+        }
+
+        const auto fallback = argument.type() == ArgumentType::Flag ? std::string_view("false")
+                                                                    : argument.defaultValue();
+
+        if (!fallback.empty() && !argument.writeBound(fallback)) {
+            return ParseErrorInfo{ParseErrorCode::InvalidValue, ParseErrorInfo::npos,
+                                    fallback, fallback, &argument};
+        }
+    }
+
+    return store.probe().measure(ParsePhase::Required, [&] { return validateRequiredArgument(store); });
+}
+
+template <typename Store>
+std::optional<ParseErrorInfo> ArgParser::stopForHelp(Store& store, ParseState state) const {
+    store.setState(state);
+
+    if (!store.prints()) {
+        return std::nullopt;
+    }
+
+    if (state == ParseState::HelpRequested) {
+        printHelp();
+    } else {
+        printVersion();
+    }
+
+    if (m_exitOnHelp) {
+        std::exit(0);
+    }
+
+    return std::nullopt;
+}
+
+// One pass over the environment, matching each name against the bound keys.
+// Values are copied because the environment may change after parsing.
+template <typename Store>
+std::optional<ParseErrorInfo> ArgParser::applyEnvironment(Store& store) const {
+    const auto& bindings = m_table->envBindings();
+    std::size_t pending = 0;
+
+    for (const auto& binding : bindings) {
+
+        if (!store.isSet(binding.second)) {
+            ++pending;
+        }
+    }
+
+    for (char** entry = ARGPARSER_ENVIRON; pending > 0 && entry && *entry; ++entry) {
+        const std::string_view variable(*entry);
+        const auto eqPos = variable.find('=');
+
+        if (eqPos == std::string_view::npos) {
+            continue;
+        }
+
+        auto it = bindings.find(variable.substr(0, eqPos));
+
+        if (it == bindings.end() || store.isSet(it->second)) {
+            continue;
+        }
+
+        auto& arg = *m_arguments[it->second];
+        const auto value = variable.substr(eqPos + 1);
+        --pending;
+
+        if (arg.type() == ArgumentType::Flag) {
+            bool enabled = false;
+
+            if (!convertValue(value, enabled)) {
+                return ParseErrorInfo{ParseErrorCode::InvalidValue, ParseErrorInfo::npos,
+                                        it->first, value, &arg};
+            }
+
+            if (enabled) {
+                store.setFlag(arg);
+            }
+
+            continue;
+        }
+
+        if (!store.setOwnedValue(arg, value)) {
+            return ParseErrorInfo{ParseErrorCode::InvalidValue, ParseErrorInfo::npos,
+                                    it->first, value, &arg};
+        }
+    }
+
+    return std::nullopt;
+}
+
+// Config values go to the arguments still unset once the environment is applied.
+template <typename Store>
+std::optional<ParseErrorInfo> ArgParser::applyConfig(Store& store) const {
+    std::size_t next = 0;
+
+    for (std::size_t first = 0; first < m_config.size(); first = next) {
+        const auto index = m_config[first].index;
+        next = first + 1;
+
+        while (next < m_config.size() && m_config[next].index == index) {
+            ++next;
+        }
+
+        if (store.isSet(index)) {
+            continue;
+        }
+
+        auto& arg = *m_arguments[index];
+
+        if (store.environment() && environmentDecides(arg)) {
+            continue;
+        }
+
+        for (auto i = first; i < next; ++i) {
+            const auto& entry = m_config[i];
+
+            if (arg.type() == ArgumentType::Flag) {
+                bool enabled = false;
+
+                if (!convertValue(entry.value, enabled)) {
+                    return ParseErrorInfo{ParseErrorCode::InvalidValue, ParseErrorInfo::npos,
+                                            entry.key, entry.value, &arg};
+                }
+
+                if (enabled) {
+                    store.setFlag(arg);
+                }
+
+                continue;
+            }
+
+            if (!store.setValue(arg, entry.value)) {
+                return ParseErrorInfo{ParseErrorCode::InvalidValue, ParseErrorInfo::npos,
+                                        entry.key, entry.value, &arg};
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto ArgParser::configValues(std::size_t index) const noexcept -> std::span<const ConfigValue> {
+    const auto first = std::partition_point(m_config.begin(), m_config.end(),
+                                            [index](const ConfigValue& value) { return value.index < index; });
+    const auto last = std::partition_point(first, m_config.end(),
+                                            [index](const ConfigValue& value) { return value.index == index; });
+
+    return {first, last};
+}
+
+// POSIX style clusters: "-vvx" sets each flag in turn, and the first option in
+// the cluster takes the rest of the token ("-ofile") or the next token as value.
+template <typename Store>
+std::optional<ParseErrorInfo> ArgParser::parseShortOption(std::string_view arg, TokenCursor& cursor,
+                                                        Store& store) const {
+    const auto tokenIndex = cursor.index();
+
+    for (std::size_t i = 1; i < arg.length(); ++i) {
+        const auto index = store.probe().lookup([&] { return m_table->findShort(arg[i]); });
+
+        if (index == ArgumentTable::npos) {
+            return ParseErrorInfo{ParseErrorCode::UnknownArgument, tokenIndex, arg, arg.substr(i, 1)};
+        }
+
+        auto& argument = *m_arguments[index];
+
+        if (argument.type() == ArgumentType::Flag) {
+            store.setFlag(argument);
+
+            continue;
+        }
+
+        std::string_view value;
+
+        if (i + 1 < arg.length()) {
+            value = arg.substr(i + 1);
+
+        } else if (!cursor.next(value)) {
+            return ParseErrorInfo{ParseErrorCode::MissingValue, tokenIndex, arg, {}, &argument};
+        }
+
+        return storeValues(arg, argument, value, cursor, store);
+    }
+
+    return std::nullopt;
+}
+
+template <typename Store>
+std::optional<ParseErrorInfo> ArgParser::parseLongOption(std::string_view arg, const Token& token,
+                                                        TokenCursor& cursor, Store& store) const {
+    const auto tokenIndex = cursor.index();
+    std::string_view value = token.value;
+    bool ambiguous = false;
+
+    auto* argument = store.probe().lookup([&]() -> Argument* {
+        auto* found = findArgument(token.key);
+
+        if (!found && m_abbreviations && !token.key.empty()) {
+            const auto index = m_table->findPrefix(token.key, ambiguous);
+
+            if (index != ArgumentTable::npos) {
+                found = m_arguments[index].get();
+            }
+        }
+
+        return found;
+    });
+
+    if (ambiguous) {
+        return ParseErrorInfo{ParseErrorCode::AmbiguousArgument, tokenIndex, arg, {}, nullptr, m_table.get()};
+    }
+
+    if (!argument) {
+        return ParseErrorInfo{ParseErrorCode::UnknownArgument, tokenIndex, arg, {}, nullptr, m_table.get()};
+    }
+    
+    if ( argument->type() == ArgumentType::Flag) {
+
+        if (token.hasValue) {
+            return ParseErrorInfo{ParseErrorCode::UnexpectedValue, tokenIndex, arg, value, argument};
+        }
+        store.setFlag(*argument);
+
+        return std::nullopt;
+    }
+        
+    if (!token.hasValue && !cursor.next(value)) {
+        return ParseErrorInfo{ParseErrorCode::MissingValue, tokenIndex, arg, {}, argument};
+    }
+
+    return storeValues(arg, *argument, value, cursor, store);
+}
+
+// An nargs(n) option takes the first value from its own token and the other
+// n - 1 from the tokens after it; each one is stored as a separate view.
+template <typename Store>
+std::optional<ParseErrorInfo> ArgParser::storeValues(std::string_view arg, Argument& argument,
+                                                    std::string_view value, TokenCursor& cursor,
+                                                    Store& store) const {
+    const auto tokenIndex = cursor.index();
+
+    for (std::size_t i = 0; i < argument.nargs(); ++i) {
+
+        if (i != 0 && !cursor.next(value)) {
+            return ParseErrorInfo{ParseErrorCode::MissingValue, tokenIndex, arg, {}, &argument};
+        }
+
+        if (!store.setValue(argument, value)) {
+            return ParseErrorInfo{ParseErrorCode::InvalidValue, tokenIndex, arg, value, &argument};
+        }
+    }
+
+    return std::nullopt;
+}
+
+// Checks every stored value in one pass once the tokens are consumed, so the
+// token loop never waits on a slow check.
+template <typename Store>
+std::optional<ParseErrorInfo> ArgParser::validateDeferred(Store& store) const {
+
+    for (const auto index : m_table->checked()) {
+
+        if (!store.isSet(index)) {
+            continue;
+        }
+
+        const auto& argument = *m_arguments[index];
+
+        for (const auto value : store.values(index)) {
+
+            if (!store.probe().accepts(argument, value)) {
+                return ParseErrorInfo{ParseErrorCode::InvalidValue, ParseErrorInfo::npos, value, value, &argument};
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+template <typename Store>
+std::optional<ParseErrorInfo> ArgParser::validateRequiredArgument(Store& store) const {
+    const auto index = store.missingRequired();
+
+    if (index != ArgumentTable::npos) {
+
+        return ParseErrorInfo{ParseErrorCode::MissingRequired, ParseErrorInfo::npos,
+                                {}, {}, m_arguments[index].get()};
+    }
+
+    return std::nullopt;
+}
+
+void ArgParser::resolveLazy(const ParseResult& result, const Argument& argument) const {
+    const auto& value = result.m_values[argument.index()];
+
+    if (!value.isSet() && !applyLazyFallback(result, argument)) {
+        return;
+    }
+
+    if (argument.type() == ArgumentType::Flag) {
+        return;
+    }
+
+    for (const auto stored : value.values()) {
+
+        if (!argument.accepts(stored)) {
+            ParseErrorInfo{ParseErrorCode::InvalidValue, ParseErrorInfo::npos, stored, stored, &argument}.raise();
+        }
+    }
+}
+
+bool ArgParser::applyLazyFallback(const ParseResult& result, const Argument& argument) const {
+    return applyLazyEnvironment(result, argument) ||
+            (!environmentDecides(argument) && applyLazyConfig(result, argument));
+}
+
+// A flag's variable may hold a false word, which leaves the flag unset but
+// still outranks the config file.
+bool ArgParser::environmentDecides(const Argument& argument) const {
+    return argument.type() == ArgumentType::Flag && environmentValue(argument) != nullptr;
+}
+
+const char* ArgParser::environmentValue(const Argument& argument) const {
+
+    if (argument.envName().empty()) {
+        return nullptr;
+    }
+
+    const auto& bindings = m_table->envBindings();
+    auto it = bindings.find(argument.envName());
+
+    return it != bindings.end() && it->second == argument.index() ? std::getenv(it->first.c_str()) : nullptr;
+}
+
+// Looks up the one variable bound to argument instead of walking the whole
+// environment for every binding; values are copied as in applyEnvironment().
+bool ArgParser::applyLazyEnvironment(const ParseResult& result, const Argument& argument) const {
+    const auto name = argument.envName();
+    const auto& bindings = m_table->envBindings();
+
+    if (name.empty()) {
+        return false;
+    }
+
+    auto it = bindings.find(name);
+
+    if (it == bindings.end() || it->second != argument.index()) {
+        return false;
+    }
+
+    for (char** entry = ARGPARSER_ENVIRON; entry && *entry; ++entry) {
+        const std::string_view variable(*entry);
+
+        if (variable.length() <= name.length() || variable[name.length()] != '=' || !variable.starts_with(name)) {
+            continue;
+        }
+
+        const auto value = variable.substr(name.length() + 1);
+
+        if (argument.type() == ArgumentType::Flag) {
+            bool enabled = false;
+
+            if (!convertValue(value, enabled)) {
+                ParseErrorInfo{ParseErrorCode::InvalidValue, ParseErrorInfo::npos, name, value, &argument}.raise();
+            }
+
+            if (!enabled) {
+                return false;
+            }
+            result.slot(argument.index()).setFlag(true);
+
+            return true;
+        }
+
+        auto& stored = result.slot(argument.index());
+
+        if (argument.isMultiValue()) {
+            stored.append(value, true);
+        } else {
+            stored.assign(value, true);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+bool ArgParser::applyLazyConfig(const ParseResult& result, const Argument& argument) const {
+    bool applied = false;
+
+    for (const auto& entry : configValues(argument.index())) {
+
+        if (argument.type() == ArgumentType::Flag) {
+            bool enabled = false;
+
+            if (!convertValue(entry.value, enabled)) {
+                ParseErrorInfo{ParseErrorCode::InvalidValue, ParseErrorInfo::npos,
+                                entry.key, entry.value, &argument}.raise();
+            }
+
+            if (enabled) {
+                result.slot(argument.index()).setFlag(true);
+                applied = true;
+            }
+
+            continue;
+        }
+
+        auto& stored = result.slot(argument.index());
+
+        if (argument.isMultiValue()) {
+            stored.append(entry.value, false);
+        } else {
+            stored.assign(entry.value, false);
+        }
+        applied = true;
+    }
+
+    return applied;
+}
+
+std::string ArgParser::getString(std::string_view name) const {
+    auto* arg = findArgument(name);
+    
+    return arg ? arg->getString() : "";
+}
+
+int ArgParser::getInt(std::string_view name) const {
+    auto* arg = findArgument(name);
+
+    if (!arg) {
+        throw ArgumentError("Argument not found: " + std::string(name));
+    }
+
+    return arg->getInt();
+}
+
+double ArgParser::getDouble(std::string_view name) const {
+    auto* arg = findArgument(name);
+
+    if (!arg) {
+        throw ArgumentError("Argument not found: " + std::string(name));
+    }
+
+    return arg->getDouble();
+}
+
+bool ArgParser::getBool(std::string_view name) const {
+    auto* arg = findArgument(name);
+
+    return arg ? arg->isSet() : false;
+}
+
+std::size_t ArgParser::count(std::string_view name) const {
+    auto* arg = findArgument(name);
+
+    return arg ? arg->count() : 0;
+}
+
+bool ArgParser::isSet(std::string_view name) const {
+    auto* arg = findArgument(name);
+
+    return arg ? arg->isSet() : false;
+}
+
+const std::vector<std::string>& ArgParser::positionalArguments() const {
+
+    if (m_positionalValues.size() != m_positionalViews.size()) {
+        m_positionalValues.assign(m_positionalViews.begin(), m_positionalViews.end());
+    }
+
+    return m_positionalValues;
+}
+
+std::span<const std::string_view> ArgParser::positionalViews() const noexcept {
+
+    return m_positionalViews;
+}
+
+std::string ArgParser::help() const {
+    std::lock_guard lock(m_helpCache->mutex);
+    const auto text = cachedHelp();
+
+    return std::string(text.substr(0, text.length() - 1));
+}
+
+std::string_view ArgParser::cachedHelp() const {
+    // Help shows the bound variables' values, so the text is also stale once
+    // one of them changes. An unset variable adds a '\0', a set one '=', its
+    // value and a '\0', which keeps the two apart.
+    std::pmr::string environment(m_resource);
+
+    for (const auto& binding : m_table->envBindings()) {
+
+        if (const char* value = std::getenv(binding.first.c_str())) {
+            environment.append("=").append(value);
+        }
+        environment.push_back('\0');
+    }
+
+    if (!m_helpCache->valid || m_helpCache->revision != m_table->revision() ||
+        m_helpCache->environment != environment) {
+        m_helpCache->text.clear();
+        appendHelp(m_helpCache->text);
+        m_helpCache->text.push_back('\n');
+        m_helpCache->revision = m_table->revision();
+        m_helpCache->environment = std::move(environment);
+        m_helpCache->valid = true;
+    }
+
+    return m_helpCache->text;
+}
+
+void ArgParser::formatHelp(std::string& out) const {
+    appendHelp(out);
+}
+
+template <typename String>
+void ArgParser::appendHelp(String& out) const {
+
+    if (!m_description.empty()) {
+        out.append(m_description).append("\n\n");
+    }
+
+    formatUsage(out);
+    out.append("\n\n");
+    formatArguments(out);
+    formatSubcommands(out);
+
+    if (!m_version.empty()) {
+        out.append("\nVersion: ").append(m_version);
+    }
+}
+
+void ArgParser::printHelp() const {
+    // Copied under the lock and written after it, so a sink may call help() or printHelp() itself.
+    std::pmr::string text(m_resource);
+
+    {
+        std::lock_guard lock(m_helpCache->mutex);
+        text = cachedHelp();
+    }
+    sink().write(text);
+}
+
+void ArgParser::printVersion() const {
+    std::pmr::string text(m_programName, m_resource);
+
+    if (!text.empty()) {
+        text.push_back(' ');
+    }
+    text.append(m_version).push_back('\n');
+    sink().write(text);
+}
+
+ArgParser& ArgParser::reserve(std::size_t arguments, std::size_t textBytes) {
+    m_arguments.reserve(m_arguments.size() + arguments);
+    // Up to a short name, a long name and a description each.
+    m_strings->reserve(3 * arguments, textBytes);
+    m_argumentsById.reserve(m_strings->size() + 3 * arguments);
+
+    return *this;
+}
+
+ArgParser& ArgParser::programName(std::string_view name) {
+    m_programName = m_strings->store(name);
+    m_table->touch();
+
+    return *this;
+} 
+
+ArgParser& ArgParser::description(std::string_view desc) {
+    m_description = m_strings->store(desc);
+    m_table->touch();
+
+    return *this;
+}
+
+ArgParser& ArgParser::version(std::string_view version) {
+    m_version = m_strings->store(version);
+    m_table->touch();
+
+    return *this;
+}
+
+ArgParser& ArgParser::responseFiles(bool enabled) {
+    m_responseFiles = enabled;
+
+    return *this;
+}
+
+ArgParser& ArgParser::deferValidation(bool enabled) {
+    m_deferValidation = enabled;
+
+    return *this;
+}
+
+ArgParser& ArgParser::loadConfig(const std::string& path) {
+    auto file = MappedFile::open(path);
+
+    if (!file) {
+        throw ArgumentError("Cannot read config file: " + path);
+    }
+
+    ConfigReader reader(file->contents());
+    ConfigEntry entry;
+    std::pmr::vector<ConfigValue> loaded(m_resource);
+
+    while (reader.next(entry)) {
+        const auto* arg = findArgument(entry.key);
+
+        if (!arg || arg->type() == ArgumentType::Positional || arg->longName() != entry.key) {
+            throw ArgumentError("Unknown option in config file " + path + ":" + std::to_string(entry.line) +
+                                ": " + std::string(entry.key));
+        }
+
+        if (bool enabled = false; arg->type() == ArgumentType::Flag && !convertValue(entry.value, enabled)) {
+            throw ArgumentError("Invalid flag value in config file " + path + ":" + std::to_string(entry.line) +
+                                ": " + std::string(entry.key) + " = " + std::string(entry.value));
+        }
+        loaded.push_back(ConfigValue{static_cast<std::uint32_t>(arg->index()), entry.key, entry.value});
+    }
+
+    if (reader.errorLine() != 0) {
+        throw ArgumentError("Malformed line in config file " + path + ":" + std::to_string(reader.errorLine()));
+    }
+
+    // The keys of the new file replace what earlier files gave them.
+    auto byIndex = [](const ConfigValue& lhs, const ConfigValue& rhs) { return lhs.index < rhs.index; };
+    std::stable_sort(loaded.begin(), loaded.end(), byIndex);
+    std::erase_if(m_config, [&](const ConfigValue& value) {
+        return std::binary_search(loaded.begin(), loaded.end(), value, byIndex);
+    });
+
+    const auto middle = m_config.insert(m_config.end(), loaded.begin(), loaded.end());
+    std::inplace_merge(m_config.begin(), middle, m_config.end(), byIndex);
+
+    m_configFiles.push_back(std::move(*file));
+    m_table->touch();
+
+    return *this;
+}
+
+ArgParser& ArgParser::output(OutputSink* sink) noexcept {
+    m_output = sink;
+
+    return *this;
+}
+
+ArgParser& ArgParser::exitOnHelp(bool enabled) {
+    m_exitOnHelp = enabled;
+
+    return *this;
+}
+
+ArgParser& ArgParser::lazy(bool enabled) {
+    m_lazy = enabled;
+
+    return *this;
+}
+
+ArgParser& ArgParser::observer(ParseObserver* observer) noexcept {
+    m_observer = observer;
+
+    return *this;
+}
+
+ArgParser& ArgParser::allowAbbreviations(bool enabled) {
+    m_abbreviations = enabled;
+
+    return *this;
+}
+
+void ArgParser::freeze(std::string& blob) {
+    freeze();
+    CompiledSchema::write(*this, blob);
+}
+
+void ArgParser::freeze() {
+    m_table->freeze();
+
+    for (const auto index : m_table->checked()) {
+        m_arguments[index]->m_checks.compile();
+    }
+}
+
+ArgParser& ArgParser::onPositional(std::function<void(std::string_view)> sink) {
+    m_positionalSink = std::move(sink);
+
+    return *this;
+}
+
+Argument* ArgParser::findArgument(std::string_view name) const {
+    const auto id = m_strings->find(name);
+
+    if (id == StringPool::npos || id >= m_argumentsById.size() || m_argumentsById[id] == ArgumentTable::npos) {
+        return nullptr;
+    }
+
+    return m_arguments[m_argumentsById[id]].get();
+}
+
+template <typename String>
+void ArgParser::formatUsage(String& out) const {
+    out.append("Usage: ").append(m_programName);
+
+    if (m_table->hasOptions()) {
+        out.append(" [OPTIONS]");
+    }
+
+    if (!m_subcommands.empty()) {
+        out.append(" <COMMAND>");
+    }
+
+    for (const auto index : m_table->positionals()) {
+        const auto& arg = m_arguments[index];
+
+        if (arg->isRequired()) {
+            out.append(" ").append(arg->name());
+        } else {
+            out.append(" [").append(arg->name()).append("]");
+        }
+    }
+}
+
+// " (default: 80, config: 8080) (env: PORT)", or " (default: 80) (env: PORT=9000)"
+// once the variable is set: the declared default, then the layer a parse
+// without the option would take its value from. A set variable outranks the
+// config file, even when it holds a false word for a flag.
+template <typename String>
+void ArgParser::appendValueSources(String& out, const Argument& arg) const {
+    const char* environment = environmentValue(arg);
+    bool open = false;
+
+    auto part = [&out, &open](std::string_view label) -> String& {
+        out.append(open ? ", " : " (").append(label).append(": ");
+        open = true;
+
+        return out;
+    };
+
+    if (!arg.defaultValue().empty()) {
+        part("default").append(arg.defaultValue());
+    }
+
+    if (const auto configured = configValues(arg.index()); !environment && !configured.empty()) {
+        // A single-valued option keeps the last value the file gave it.
+        const auto shown = arg.isMultiValue() ? configured : configured.last(1);
+        auto& text = part("config");
+
+        for (std::size_t i = 0; i < shown.size(); ++i) {
+            text.append(i ? ", " : "").append(shown[i].value);
+        }
+    }
+
+    if (open) {
+        out.append(")");
+    }
+
+    if (!arg.envName().empty()) {
+        out.append(" (env: ").append(arg.envName());
+
+        if (environment) {
+            out.append("=").append(environment);
+        }
+        out.append(")");
+    }
+}
+
+template <typename String>
+void ArgParser::formatArguments(String& out) const {
+    const auto width = m_table->labelWidth();
+    const auto types = m_table->types();
+
+    if (!m_table->positionals().empty()) {
+        out.append("Positional arguments: \n");
+    }
+
+    for (const auto index : m_table->positionals()) {
+        const auto& arg = *m_arguments[index];
+        const auto label = arg.name();
+
+        out.append(" ").append(label).append(width - std::min(width, label.length()), ' ');
+        out.append(" ").append(arg.description());
+
+        if (arg.isRequired()) {
+            out.append(" (required)");
+        }
+        out.append("\n");
+    }
+
+    if (!m_table->hasOptions()) {
+        return;
+    }
+
+    if (!m_table->positionals().empty()) {
+        out.append("\n");
+    }
+    out.append("Options: \n");
+
+    for (std::size_t i = 0; i < types.size(); ++i) {
+
+        if (types[i] == ArgumentType::Positional) {
+            continue;
+        }
+
+        const auto& arg = *m_arguments[i];
+        out.append(" ");
+        const auto written = appendOptionLabel(out, arg);
+
+        out.append(width - std::min(width, written), ' ');
+        out.append(" ").append(arg.description());
+
+        appendValueSources(out, arg);
+
+        if (arg.isRequired()) {
+            out.append(" (required)");
+        }
+        out.append("\n");
+    }
+}
+
+template <typename String>
+void ArgParser::formatSubcommands(String& out) const {
+
+    if (m_subcommands.empty()) {
+        return;
+    }
+
+    auto width = m_table->labelWidth();
+
+    for (const auto& subcommand : m_subcommands) {
+        width = std::max(width, subcommand->name.length());
+    }
+
+    if (m_table->size() != 0) {
+        out.append("\n");
+    }
+    out.append("Commands: \n");
+
+    for (const auto& subcommand : m_subcommands) {
+        out.append(" ").append(subcommand->name).append(width - subcommand->name.length(), ' ');
+        out.append(" ").append(subcommand->description).append("\n");
+    }
+}
+
+}
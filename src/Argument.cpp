@@ -6,59 +6,193 @@
 
 namespace argparser {
 
-Argument::Argument(std::string_view shortName, std::string_view longName,
-                    std::string_view description)
-    : m_shortName(shortName), m_longName(longName), m_description(description),
-    m_type(ArgumentType::Flag) {}
+Argument::Argument(StringPool& strings, std::string_view shortName, std::string_view longName,
+                    std::string_view description, const allocator_type& alloc)
+    : m_strings(&strings), m_shortName(strings.store(shortName)), m_longName(strings.store(longName)),
+    m_description(strings.store(description)), m_type(ArgumentType::Flag), m_checks(alloc), m_value(alloc) {}
 
-Argument::Argument(std::string_view shortName, std::string_view longName, 
-                    std::string_view description, std::string_view defaultValue)
-    : m_shortName(shortName), m_longName(longName), m_description(description),
-    m_defaultValue(defaultValue), m_type(ArgumentType::Option) {}
+Argument::Argument(StringPool& strings, std::string_view shortName, std::string_view longName,
+                    std::string_view description, std::string_view defaultValue,
+                    const allocator_type& alloc)
+    : m_strings(&strings), m_shortName(strings.store(shortName)), m_longName(strings.store(longName)),
+    m_description(strings.store(description)), m_defaultValue(strings.store(defaultValue)),
+    m_type(ArgumentType::Option), m_checks(alloc), m_value(alloc) {}
 
-Argument::Argument(std::string_view name, std::string_view description,
-                    bool required)
-    : m_name(name), m_description(description), m_isRequired(required),
-    m_type(ArgumentType::Positional) {}
+Argument::Argument(StringPool& strings, std::string_view name, std::string_view description,
+                    bool required, const allocator_type& alloc)
+    : m_strings(&strings), m_name(strings.store(name)), m_description(strings.store(description)),
+    m_type(ArgumentType::Positional), m_isRequired(required), m_checks(alloc), m_value(alloc) {}
 
 Argument& Argument::required(bool isRequired) {
     m_isRequired = isRequired;
 
+    if (m_table) {
+        m_table->setRequired(m_index, isRequired);
+    }
+
     return *this;
 }
 
 Argument& Argument::defaultValue(std::string_view value) {
-    m_defaultValue = value;
+    m_defaultValue = m_strings->store(value);
+    m_value.invalidate();
+    schemaChanged();
 
     return *this;
 }
 
 Argument& Argument::help(std::string_view description) {
-    m_description = description;
+    m_description = m_strings->store(description);
+    schemaChanged();
 
     return *this;
 }
 
 Argument& Argument::validator(ValidatorFunction func) {
     m_validator = std::move(func);
+    checksChanged();
+
+    return *this;
+}
+
+Argument& Argument::range(double min, double max) {
+    m_checks.range(min, max);
+    checksChanged();
+
+    return *this;
+}
+
+Argument& Argument::choices(std::initializer_list<std::string_view> values) {
+    m_checks.choices(values);
+    checksChanged();
+
+    return *this;
+}
+
+Argument& Argument::length(std::size_t min, std::size_t max) {
+    m_checks.length(min, max);
+    checksChanged();
+
+    return *this;
+}
+
+Argument& Argument::pattern(std::string_view regex) {
+    m_checks.pattern(regex);
+    checksChanged();
+
+    return *this;
+}
+
+Argument& Argument::pathExists(bool enabled) {
+    m_checks.pathExists(enabled);
+    checksChanged();
+
+    return *this;
+}
+
+Argument& Argument::env(std::string_view name) {
+
+    if (m_table) {
+        m_table->bindEnv(m_index, name);
+    }
+    m_envName = m_strings->store(name);
+
+    return *this;
+}
+
+Argument& Argument::append(bool enabled) {
+    m_append = enabled;
+    schemaChanged();
+
+    return *this;
+}
+
+Argument& Argument::nargs(std::size_t count) {
+
+    if (count == 0) {
+        throw ArgumentError("nargs must be at least 1");
+    }
+    m_nargs = count;
+    m_append = true;
+    schemaChanged();
 
     return *this;
 }
 
 void Argument::setValue(std::string_view value) {
+    checkValue(value);
 
-    if (m_type ==ArgumentType::Flag) {
-        throw ValidationError("Cannot set value for flag argument");
+    if (!store(value, true)) {
+        throw ValidationError("Cannot convert value for bound argument: " + std::string(value));
     }
+}
 
-    std::string valueStr(value);
+void Argument::setValueView(std::string_view value) {
+    checkValue(value);
 
-    if (m_validator && !m_validator(valueStr)) {
-        throw ValidationError("Invalid value for argument:" + valueStr);
+    if (!store(value, false)) {
+        throw ValidationError("Cannot convert value for bound argument: " + std::string(value));
     }
+}
 
-    m_currentValue = valueStr;
-    m_isSet = true;
+bool Argument::trySetValue(std::string_view value) {
+
+    if (m_type == ArgumentType::Flag || !accepts(value)) {
+        return false;
+    }
+
+    return store(value, true);
+}
+
+bool Argument::trySetValueView(std::string_view value) {
+
+    if (m_type == ArgumentType::Flag || !accepts(value)) {
+        return false;
+    }
+
+    return store(value, false);
+}
+
+bool Argument::store(std::string_view value, bool owned) {
+
+    if (m_append) {
+        m_value.append(value, owned);
+    } else {
+        m_value.assign(value, owned);
+    }
+
+    // The stored copy, since an owned value may not outlive this call.
+    return writeBound(m_value.values().back());
+}
+
+void Argument::schemaChanged() noexcept {
+
+    if (m_table) {
+        m_table->touch();
+    }
+}
+
+void Argument::checksChanged() {
+
+    if (m_table) {
+        m_table->setChecked(m_index, hasValidator());
+    }
+}
+
+bool Argument::accepts(std::string_view value) const {
+
+    return m_checks.accepts(value) && (!m_validator || m_validator(std::string(value)));
+}
+
+void Argument::checkValue(std::string_view value) const {
+
+    if (m_type ==ArgumentType::Flag) {
+        throw ValidationError("Cannot set value for flag argument");
+    }
+
+    if (!accepts(value)) {
+        throw ValidationError("Invalid value for argument:" + std::string(value));
+    }
 }
 
 void Argument::setFlag(bool value) {
@@ -67,7 +201,152 @@ void Argument::setFlag(bool value) {
         throw ValidationError("Cannot set flag for non-flag argument");
     }
 
+    m_value.setFlag(value);
+    (void)writeBound(value ? "true" : "false");
+}
+
+ArgumentValue::ArgumentValue(const ArgumentValue& other, const allocator_type& alloc)
+    : m_ownedValue(other.m_ownedValue, alloc), m_view(other.m_view), m_values(other.m_values, alloc),
+    m_pool(other.m_pool, alloc), m_isSet(other.m_isSet), m_ownsValue(other.m_ownsValue),
+    m_count(other.m_count), m_int(other.m_int), m_double(other.m_double), m_bool(other.m_bool) {
+    rebaseViews(other.buffers());
+}
+
+ArgumentValue::ArgumentValue(ArgumentValue&& other, const allocator_type& alloc)
+    : ArgumentValue(alloc) {
+    *this = std::move(other);
+}
+
+ArgumentValue::ArgumentValue(const ArgumentValue& other)
+    : ArgumentValue(other, other.m_ownedValue.get_allocator()) {}
+
+ArgumentValue::ArgumentValue(ArgumentValue&& other) noexcept
+    : ArgumentValue(other.m_ownedValue.get_allocator()) {
+    *this = std::move(other);
+}
+
+ArgumentValue& ArgumentValue::operator=(const ArgumentValue& other) {
+
+    if (this != &other) {
+        m_ownedValue = other.m_ownedValue;
+        m_view = other.m_view;
+        m_values = other.m_values;
+        m_pool = other.m_pool;
+        m_isSet = other.m_isSet;
+        m_ownsValue = other.m_ownsValue;
+        m_count = other.m_count;
+        m_int = other.m_int;
+        m_double = other.m_double;
+        m_bool = other.m_bool;
+        rebaseViews(other.buffers());
+    }
+
+    return *this;
+}
+
+ArgumentValue& ArgumentValue::operator=(ArgumentValue&& other) noexcept {
+
+    if (this != &other) {
+        // Short strings move their characters, so remember where they were.
+        const auto from = other.buffers();
+        m_ownedValue = std::move(other.m_ownedValue);
+        m_view = other.m_view;
+        m_values = std::move(other.m_values);
+        m_pool = std::move(other.m_pool);
+        m_isSet = other.m_isSet;
+        m_ownsValue = other.m_ownsValue;
+        m_count = other.m_count;
+        m_int = other.m_int;
+        m_double = other.m_double;
+        m_bool = other.m_bool;
+        rebaseViews(from);
+    }
+
+    return *this;
+}
+
+void ArgumentValue::rebaseViews(const BufferRanges& from) noexcept {
+    const BufferRanges to = buffers();
+
+    auto rebase = [&from, &to](std::string_view& view) {
+
+        for (std::size_t i = 0; i < from.size(); ++i) {
+            const auto* first = from[i].data();
+
+            if (!view.empty() && view.data() >= first && view.data() + view.size() <= first + from[i].size()) {
+                view = std::string_view(to[i].data() + (view.data() - first), view.size());
+
+                return;
+            }
+        }
+    };
+
+    rebase(m_view);
+
+    for (auto& view : m_values) {
+        rebase(view);
+    }
+}
+
+void ArgumentValue::invalidate() const noexcept {
+    m_int.reset();
+    m_double.reset();
+    m_bool.reset();
+}
+
+void ArgumentValue::assign(std::string_view value, bool owned) {
+
+    if (owned) {
+        m_ownedValue = value;
+    } else {
+        m_view = value;
+    }
+    m_ownsValue = owned;
+    m_isSet = true;
+    ++m_count;
+    invalidate();
+
+    m_values.clear();
+    m_values.push_back(this->value());
+}
+
+void ArgumentValue::append(std::string_view value, bool owned) {
+    std::string_view stored = value;
+
+    if (owned) {
+        const auto from = buffers();
+        const auto offset = m_pool.size();
+        m_pool.append(value);
+
+        if (m_pool.data() != from[1].data()) {
+            rebaseViews(from);
+        }
+        stored = std::string_view(m_pool).substr(offset);
+    }
+
+    m_values.push_back(stored);
+    m_view = stored;
+    m_ownsValue = false;
+    m_isSet = true;
+    ++m_count;
+    invalidate();
+}
+
+void ArgumentValue::setFlag(bool value) noexcept {
     m_isSet = value;
+    m_count = value ? m_count + 1 : 0;
+    invalidate();
+}
+
+void ArgumentValue::clear() noexcept {
+    m_ownedValue.clear();
+    m_view = {};
+    m_values.clear();
+    m_pool.clear();
+    m_isSet = false;
+    m_ownsValue = false;
+    m_count = 0;
+    invalidate();
 }
 
 std::string Argument::getString() const {
@@ -104,7 +383,7 @@ bool Argument::getBool() const {
 
 bool Argument::validate (const std::string& value) const {
     
-    return !m_validator || m_validator(value);
+    return accepts(value);
 }
 
 }
\ No newline at end of file
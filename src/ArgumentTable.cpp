@@ -0,0 +1,188 @@
+#include "ArgumentTable.hpp"
+#include "Exceptions.hpp"
+
+#include <algorithm>
+
+namespace argparser {
+
+namespace {
+
+// Keeps indices sorted and unique, so parse-time scans walk them in schema order.
+void updateIndexSet(std::pmr::vector<std::uint32_t>& indices, std::size_t index, bool present) {
+    const auto value = static_cast<std::uint32_t>(index);
+    auto it = std::lower_bound(indices.begin(), indices.end(), value);
+    const bool found = it != indices.end() && *it == value;
+
+    if (present && !found) {
+        indices.insert(it, value);
+
+    } else if (!present && found) {
+        indices.erase(it);
+    }
+}
+
+// Levenshtein distance between lhs and rhs, or bound + 1 as soon as it is
+// known to exceed bound. Only the diagonal band of width 2 * bound + 1 is
+// computed, so the cost is O(length * bound) per name.
+std::size_t boundedEditDistance(std::string_view lhs, std::string_view rhs, std::size_t bound) {
+    constexpr std::size_t maxLength = 64;
+    const std::size_t over = bound + 1;
+
+    if (lhs.length() > rhs.length()) {
+        std::swap(lhs, rhs);
+    }
+
+    if (rhs.length() - lhs.length() > bound || rhs.length() >= maxLength) {
+        return over;
+    }
+
+    std::size_t row[maxLength];
+
+    for (std::size_t j = 0; j <= lhs.length(); ++j) {
+        row[j] = std::min(j, over);
+    }
+
+    for (std::size_t i = 1; i <= rhs.length(); ++i) {
+        const std::size_t first = i > bound ? i - bound : 1;
+        const std::size_t last = std::min(lhs.length(), i + bound);
+        std::size_t diagonal = row[first - 1];
+        row[first - 1] = first == 1 ? std::min(i, over) : over;
+        std::size_t rowMinimum = row[first - 1];
+
+        for (std::size_t j = first; j <= last; ++j) {
+            const std::size_t above = row[j];
+            const std::size_t cost = rhs[i - 1] == lhs[j - 1] ? 0 : 1;
+            row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + cost, over});
+            diagonal = above;
+            rowMinimum = std::min(rowMinimum, row[j]);
+        }
+
+        if (rowMinimum > bound) {
+            return over;
+        }
+    }
+
+    return row[lhs.length()];
+}
+
+}
+
+void ArgumentTable::add(ArgumentType type, bool required, std::size_t labelWidth) {
+    const auto index = static_cast<std::uint32_t>(m_types.size());
+    m_types.push_back(type);
+    m_requiredMask.resize((m_types.size() + 63) / 64);
+    m_labelWidth = std::max(m_labelWidth, labelWidth);
+
+    if (type == ArgumentType::Positional) {
+        m_positionals.push_back(index);
+    } else {
+        ++m_optionCount;
+    }
+
+    if (required) {
+        m_required.push_back(index);
+        m_requiredMask[index / 64] |= std::uint64_t{1} << (index % 64);
+    }
+    touch();
+}
+
+void ArgumentTable::setRequired(std::size_t index, bool required) {
+    updateIndexSet(m_required, index, required);
+    const auto bit = std::uint64_t{1} << (index % 64);
+
+    if (required) {
+        m_requiredMask[index / 64] |= bit;
+    } else {
+        m_requiredMask[index / 64] &= ~bit;
+    }
+    touch();
+}
+
+void ArgumentTable::setBound(std::size_t index, bool bound) {
+    updateIndexSet(m_bound, index, bound);
+    touch();
+}
+
+void ArgumentTable::setChecked(std::size_t index, bool checked) {
+    updateIndexSet(m_checked, index, checked);
+    touch();
+}
+
+void ArgumentTable::setShortName(char name, std::size_t index) noexcept {
+    const auto code = static_cast<unsigned char>(name);
+
+    if (code < m_shortNames.size()) {
+        m_shortNames[code] = static_cast<std::uint32_t>(index);
+    }
+}
+
+void ArgumentTable::addLongName(std::string_view name, std::size_t index) {
+    m_longNames.push_back(NameEntry{name, static_cast<std::uint32_t>(index)});
+    m_frozen = m_longNames.size() < 2 ||
+        (m_frozen && m_longNames[m_longNames.size() - 2].name < name);
+}
+
+void ArgumentTable::freeze() {
+
+    if (!m_frozen) {
+        std::stable_sort(m_longNames.begin(), m_longNames.end(), [](const NameEntry& lhs, const NameEntry& rhs) {
+            return lhs.name < rhs.name;
+        });
+        m_frozen = true;
+    }
+}
+
+std::uint32_t ArgumentTable::findPrefix(std::string_view prefix, bool& ambiguous) const {
+    std::uint32_t match = npos;
+    ambiguous = false;
+
+    visitPrefix(prefix, [&](const NameEntry& entry) {
+
+        if (match == npos) {
+            match = entry.index;
+
+        } else if (match != entry.index) {
+            ambiguous = true;
+        }
+    });
+
+    return ambiguous ? npos : match;
+}
+
+std::string_view ArgumentTable::suggest(std::string_view name) const {
+    const std::size_t bound = name.length() <= 4 ? 1 : (name.length() <= 8 ? 2 : 3);
+    std::string_view best;
+    std::size_t bestDistance = bound;
+
+    for (const auto& entry : m_longNames) {
+        const auto distance = boundedEditDistance(name, entry.name, bestDistance);
+
+        if (distance > bestDistance) {
+            continue;
+        }
+
+        if (best.empty() || distance < bestDistance || entry.name < best) {
+            best = entry.name;
+            bestDistance = distance;
+        }
+    }
+
+    return best;
+}
+
+void ArgumentTable::bindEnv(std::size_t index, std::string_view name) {
+    const auto value = static_cast<std::uint32_t>(index);
+
+    if (auto it = m_env.find(name); it != m_env.end() && it->second != value) {
+        throw ArgumentError("Environment variable is already bound to another argument: " + std::string(name));
+    }
+
+    std::erase_if(m_env, [value](const auto& entry) { return entry.second == value; });
+
+    if (!name.empty()) {
+        m_env.insert_or_assign(std::pmr::string(name, m_env.get_allocator()), value);
+    }
+    touch();
+}
+
+}
@@ -0,0 +1,110 @@
+#include "BatchParse.hpp"
+#include "ArgParser.hpp"
+
+#include <utility>
+
+namespace argparser {
+
+ThreadPoolExecutor::ThreadPoolExecutor(std::size_t threads) {
+    const auto workers = threads > 1 ? threads - 1 : 0;
+    m_workers.reserve(workers);
+
+    for (std::size_t i = 0; i < workers; ++i) {
+        m_workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPoolExecutor::run(std::size_t count, const std::function<void(std::size_t)>& task) {
+
+    if (count == 0) {
+        return;
+    }
+
+    std::lock_guard turn(m_runMutex);
+    std::unique_lock lock(m_mutex);
+    m_task = &task;
+    m_count = count;
+    m_next = 0;
+    m_pending = count;
+    m_error = nullptr;
+    m_wake.notify_all();
+
+    runPending(lock);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+
+    m_task = nullptr;
+    m_count = 0;
+    m_next = 0;
+    auto error = std::exchange(m_error, nullptr);
+    lock.unlock();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPoolExecutor::workerLoop() {
+    std::unique_lock lock(m_mutex);
+
+    while (true) {
+        m_wake.wait(lock, [this] { return m_stop || m_next < m_count; });
+
+        if (m_stop) {
+            return;
+        }
+        runPending(lock);
+    }
+}
+
+void ThreadPoolExecutor::runPending(std::unique_lock<std::mutex>& lock) {
+
+    while (m_next < m_count) {
+        const auto index = m_next++;
+        const auto* task = m_task;
+        lock.unlock();
+
+        std::exception_ptr error;
+
+        try {
+            (*task)(index);
+
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+
+        if (error && !m_error) {
+            m_error = error;
+        }
+
+        if (--m_pending == 0) {
+            m_done.notify_all();
+        }
+    }
+}
+
+std::size_t BatchResult::column(std::string_view name) const {
+
+    if (!m_schema) {
+        return npos;
+    }
+
+    const auto* arg = m_schema->findArgument(name);
+
+    return arg && arg->index() < m_columns ? arg->index() : npos;
+}
+
+}
@@ -0,0 +1,736 @@
+#include "CompiledSchema.hpp"
+#include "ArgParser.hpp"
+#include "Tokenizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace argparser {
+
+namespace {
+
+// Blob layout, all integers uint32 in host byte order:
+//
+//     header      magic, version, byte order mark, counts, program texts
+//     records     one per argument: six string refs, type, flags, nargs
+//     shortNames  128 argument indices, npos for unused characters
+//     buckets     displacement per perfect hash bucket, 0 for empty buckets
+//     slots       string ref of the name and the argument index
+//     positionals indices of the positional arguments in declaration order
+//     required    indices of the required arguments
+//     strings     every name and text once, referenced by offset and length
+constexpr std::string_view magic = "ARGPSCHM";
+constexpr std::uint32_t formatVersion = 1;
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+
+constexpr std::size_t headerSize = 64;
+constexpr std::size_t stringRefSize = 8;
+constexpr std::size_t recordSize = 56;
+constexpr std::size_t slotSize = 12;
+constexpr std::size_t shortNameCount = 128;
+
+// Header fields.
+constexpr std::size_t versionOffset = 8;
+constexpr std::size_t byteOrderOffset = 12;
+constexpr std::size_t argumentCountOffset = 16;
+constexpr std::size_t bucketCountOffset = 20;
+constexpr std::size_t slotCountOffset = 24;
+constexpr std::size_t positionalCountOffset = 28;
+constexpr std::size_t requiredCountOffset = 32;
+constexpr std::size_t stringBytesOffset = 36;
+constexpr std::size_t programNameOffset = 40;
+constexpr std::size_t descriptionOffset = 48;
+constexpr std::size_t versionTextOffset = 56;
+
+// Record fields.
+enum RecordString : std::size_t {
+    ShortName,
+    LongName,
+    Name,
+    Description,
+    DefaultValue,
+    Label,
+    RecordStringCount
+};
+
+constexpr std::size_t typeOffset = RecordStringCount * stringRefSize;
+constexpr std::size_t flagsOffset = typeOffset + 1;
+constexpr std::size_t nargsOffset = typeOffset + 4;
+
+constexpr std::uint8_t requiredFlag = 1 << 0;
+constexpr std::uint8_t multiValueFlag = 1 << 1;
+
+static_assert(nargsOffset + 4 == recordSize);
+
+[[nodiscard]] std::uint32_t read32(const char* at) noexcept {
+    std::uint32_t value;
+    std::memcpy(&value, at, sizeof(value));
+
+    return value;
+}
+
+void write32(std::string& out, std::uint32_t value) {
+    char bytes[sizeof(value)];
+    std::memcpy(bytes, &value, sizeof(value));
+    out.append(bytes, sizeof(value));
+}
+
+[[nodiscard]] std::uint64_t hashName(std::string_view name) noexcept {
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+
+    for (const char c : name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+// Reseeds an FNV-1a hash and runs it through the murmur3 finalizer.
+[[nodiscard]] std::uint64_t mix(std::uint64_t hash, std::uint32_t seed) noexcept {
+    hash ^= (seed + 1) * 0x9e3779b97f4a7c15ull;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+struct StringRef {
+    std::uint32_t offset = 0;
+    std::uint32_t length = 0;
+};
+
+// Each distinct string is stored once; descriptions and defaults repeat a lot.
+class StringTable {
+public:
+    StringRef intern(std::string_view value) {
+
+        if (value.empty()) {
+            return {};
+        }
+
+        auto [it, inserted] = m_offsets.try_emplace(std::string(value), static_cast<std::uint32_t>(m_bytes.size()));
+
+        if (inserted) {
+            m_bytes.append(value);
+        }
+
+        return {it->second, static_cast<std::uint32_t>(value.length())};
+    }
+
+    [[nodiscard]] const std::string& bytes() const noexcept { return m_bytes; }
+
+private:
+    std::string m_bytes;
+    std::unordered_map<std::string, std::uint32_t> m_offsets;
+};
+
+void writeRef(std::string& out, StringRef ref) {
+    write32(out, ref.offset);
+    write32(out, ref.length);
+}
+
+[[noreturn]] void invalidBlob(const char* reason) {
+    throw ArgumentError(std::string("Invalid schema blob: ") + reason);
+}
+
+}
+
+CompiledSchema::CompiledSchema(std::string_view blob) : m_blob(blob) {
+    const char* data = blob.data();
+
+    if (blob.size() < headerSize || blob.substr(0, magic.size()) != magic) {
+        invalidBlob("missing header");
+    }
+
+    if (read32(data + versionOffset) != formatVersion) {
+        invalidBlob("unsupported version");
+    }
+
+    if (read32(data + byteOrderOffset) != byteOrderMark) {
+        invalidBlob("written with a different byte order");
+    }
+
+    m_argumentCount = read32(data + argumentCountOffset);
+    m_bucketCount = read32(data + bucketCountOffset);
+    m_slotCount = read32(data + slotCountOffset);
+    m_positionalCount = read32(data + positionalCountOffset);
+    m_requiredCount = read32(data + requiredCountOffset);
+    const std::uint64_t stringBytes = read32(data + stringBytesOffset);
+
+    if (m_bucketCount == 0 || m_slotCount == 0 || (m_slotCount & (m_slotCount - 1)) != 0) {
+        invalidBlob("malformed hash table");
+    }
+
+    std::uint64_t offset = headerSize;
+    auto section = [&](std::uint64_t bytes) {
+        const auto start = offset;
+        offset += bytes;
+
+        return start;
+    };
+
+    const auto records = section(std::uint64_t{m_argumentCount} * recordSize);
+    const auto shortNames = section(shortNameCount * 4);
+    const auto displacements = section(std::uint64_t{m_bucketCount} * 4);
+    const auto slots = section(std::uint64_t{m_slotCount} * slotSize);
+    const auto positionals = section(std::uint64_t{m_positionalCount} * 4);
+    const auto required = section(std::uint64_t{m_requiredCount} * 4);
+    const auto strings = section(stringBytes);
+
+    if (offset != blob.size()) {
+        invalidBlob("size does not match the header");
+    }
+
+    m_records = data + records;
+    m_shortNames = data + shortNames;
+    m_displacements = data + displacements;
+    m_slots = data + slots;
+    m_positionals = data + positionals;
+    m_required = data + required;
+    m_strings = blob.substr(strings);
+
+    auto checkRef = [this](const char* ref) {
+
+        if (std::uint64_t{read32(ref)} + read32(ref + 4) > m_strings.size()) {
+            invalidBlob("string out of range");
+        }
+    };
+
+    auto checkIndex = [this](std::uint32_t index, bool allowNpos) {
+
+        if (index >= m_argumentCount && !(allowNpos && index == npos)) {
+            invalidBlob("argument index out of range");
+        }
+    };
+
+    checkRef(data + programNameOffset);
+    checkRef(data + descriptionOffset);
+    checkRef(data + versionTextOffset);
+
+    for (std::size_t i = 0; i < m_argumentCount; ++i) {
+        const char* entry = record(i);
+
+        for (std::size_t field = 0; field < RecordStringCount; ++field) {
+            checkRef(entry + field * stringRefSize);
+        }
+
+        if (static_cast<std::uint8_t>(entry[typeOffset]) > static_cast<std::uint8_t>(ArgumentType::Positional) ||
+            read32(entry + nargsOffset) == 0) {
+            invalidBlob("malformed argument record");
+        }
+    }
+
+    for (std::size_t i = 0; i < shortNameCount; ++i) {
+        checkIndex(read32(m_shortNames + i * 4), true);
+    }
+
+    for (std::size_t i = 0; i < m_slotCount; ++i) {
+        checkRef(m_slots + i * slotSize);
+        checkIndex(read32(m_slots + i * slotSize + stringRefSize), true);
+    }
+
+    for (std::size_t i = 0; i < m_positionalCount; ++i) {
+        checkIndex(read32(m_positionals + i * 4), false);
+    }
+
+    for (std::size_t i = 0; i < m_requiredCount; ++i) {
+        checkIndex(read32(m_required + i * 4), false);
+    }
+
+    m_programName = string(data + programNameOffset);
+    m_description = string(data + descriptionOffset);
+    m_version = string(data + versionTextOffset);
+}
+
+CompiledSchema CompiledSchema::open(const std::string& path) {
+    auto file = MappedFile::open(path);
+
+    if (!file) {
+        throw ArgumentError("Cannot read schema blob: " + path);
+    }
+
+    CompiledSchema schema(file->contents());
+    schema.m_file = std::move(file);
+
+    return schema;
+}
+
+std::string_view CompiledSchema::string(const char* ref) const noexcept {
+    return m_strings.substr(read32(ref), read32(ref + 4));
+}
+
+const char* CompiledSchema::record(std::size_t index) const noexcept {
+    return m_records + index * recordSize;
+}
+
+std::uint32_t CompiledSchema::find(std::string_view name) const noexcept {
+    const auto hash = hashName(name);
+    const auto displacement = read32(m_displacements + (mix(hash, 0) % m_bucketCount) * 4);
+
+    if (displacement == 0) {
+        return npos;
+    }
+
+    const char* slot = m_slots + (mix(hash, displacement) & (m_slotCount - 1)) * slotSize;
+    const auto index = read32(slot + stringRefSize);
+
+    return index != npos && string(slot) == name ? index : npos;
+}
+
+std::uint32_t CompiledSchema::findShort(char name) const noexcept {
+    const auto code = static_cast<unsigned char>(name);
+
+    return code < shortNameCount ? read32(m_shortNames + code * 4) : npos;
+}
+
+ArgumentType CompiledSchema::type(std::size_t index) const noexcept {
+    return static_cast<ArgumentType>(record(index)[typeOffset]);
+}
+
+std::string_view CompiledSchema::shortName(std::size_t index) const noexcept {
+    return string(record(index) + ShortName * stringRefSize);
+}
+
+std::string_view CompiledSchema::longName(std::size_t index) const noexcept {
+    return string(record(index) + LongName * stringRefSize);
+}
+
+std::string_view CompiledSchema::name(std::size_t index) const noexcept {
+    return string(record(index) + Name * stringRefSize);
+}
+
+std::string_view CompiledSchema::description(std::size_t index) const noexcept {
+    return string(record(index) + Description * stringRefSize);
+}
+
+std::string_view CompiledSchema::defaultValue(std::size_t index) const noexcept {
+    return string(record(index) + DefaultValue * stringRefSize);
+}
+
+std::string_view CompiledSchema::label(std::size_t index) const noexcept {
+    return string(record(index) + Label * stringRefSize);
+}
+
+bool CompiledSchema::isRequired(std::size_t index) const noexcept {
+    return (static_cast<std::uint8_t>(record(index)[flagsOffset]) & requiredFlag) != 0;
+}
+
+bool CompiledSchema::isMultiValue(std::size_t index) const noexcept {
+    return (static_cast<std::uint8_t>(record(index)[flagsOffset]) & multiValueFlag) != 0;
+}
+
+std::size_t CompiledSchema::nargs(std::size_t index) const noexcept {
+    return read32(record(index) + nargsOffset);
+}
+
+void CompiledSchema::parseOptions(int argc, char* argv[], CompiledResult& result) const {
+
+    if (auto error = tryParse(argc, argv, result)) {
+        error->raise();
+    }
+}
+
+std::optional<ParseErrorInfo> CompiledSchema::tryParse(int argc, char* argv[], CompiledResult& result) const {
+    ArgvTokenSource source(argc, argv);
+
+    return tryParse(source, result);
+}
+
+std::optional<ParseErrorInfo> CompiledSchema::tryParse(TokenSource& source, CompiledResult& result) const {
+
+    if (result.m_schema != this || result.m_values.size() != m_argumentCount) {
+        result.m_values.assign(m_argumentCount, std::string_view{});
+        result.m_counts.assign(m_argumentCount, 0);
+        result.m_touched.clear();
+        result.m_schema = this;
+    }
+    result.clear();
+
+    std::size_t consumed = 0;
+
+    auto next = [&source, &consumed](std::string_view& token) {
+
+        if (!source.next(token)) {
+            return false;
+        }
+        ++consumed;
+
+        return true;
+    };
+
+    // An nargs(n) option takes the first value from its own token and the
+    // other n - 1 from the tokens after it.
+    auto storeValues = [&](std::uint32_t index, std::string_view arg,
+                            std::string_view value) -> std::optional<ParseErrorInfo> {
+        const auto tokenIndex = consumed - 1;
+
+        for (std::size_t i = 0; i < nargs(index); ++i) {
+
+            if (i != 0 && !next(value)) {
+                return ParseErrorInfo{ParseErrorCode::MissingValue, tokenIndex, arg, {}};
+            }
+            result.store(index, value);
+        }
+
+        return std::nullopt;
+    };
+
+    std::string_view arg;
+
+    while (next(arg)) {
+        const auto tokenIndex = consumed - 1;
+        const auto token = splitToken(arg);
+
+        if (token.kind == TokenKind::Long) {
+            const auto index = find(token.key);
+
+            if (index == npos) {
+                return ParseErrorInfo{ParseErrorCode::UnknownArgument, tokenIndex, arg, {}};
+            }
+
+            if (type(index) == ArgumentType::Flag) {
+
+                if (token.hasValue) {
+                    return ParseErrorInfo{ParseErrorCode::UnexpectedValue, tokenIndex, arg, token.value};
+                }
+                result.store(index, {});
+
+                continue;
+            }
+
+            std::string_view value = token.value;
+
+            if (!token.hasValue && !next(value)) {
+                return ParseErrorInfo{ParseErrorCode::MissingValue, tokenIndex, arg, {}};
+            }
+
+            if (auto error = storeValues(index, arg, value)) {
+                return error;
+            }
+
+        } else if (token.kind == TokenKind::Short) {
+
+            for (std::size_t i = 1; i < arg.length(); ++i) {
+                const auto index = findShort(arg[i]);
+
+                if (index == npos) {
+                    return ParseErrorInfo{ParseErrorCode::UnknownArgument, tokenIndex, arg, arg.substr(i, 1)};
+                }
+
+                if (type(index) == ArgumentType::Flag) {
+                    result.store(index, {});
+
+                    continue;
+                }
+
+                std::string_view value;
+
+                if (i + 1 < arg.length()) {
+                    value = arg.substr(i + 1);
+
+                } else if (!next(value)) {
+                    return ParseErrorInfo{ParseErrorCode::MissingValue, tokenIndex, arg, {}};
+                }
+
+                if (auto error = storeValues(index, arg, value)) {
+                    return error;
+                }
+
+                break;
+            }
+
+        } else {
+            result.m_positionals.push_back(arg);
+        }
+    }
+
+    const auto assigned = std::min<std::size_t>(result.m_positionals.size(), m_positionalCount);
+
+    for (std::size_t i = 0; i < assigned; ++i) {
+        result.store(read32(m_positionals + i * 4), result.m_positionals[i]);
+    }
+
+    for (std::size_t i = 0; i < m_requiredCount; ++i) {
+        const auto index = read32(m_required + i * 4);
+
+        if (result.m_counts[index] == 0) {
+            return ParseErrorInfo{ParseErrorCode::MissingRequired, ParseErrorInfo::npos, label(index), {}};
+        }
+    }
+
+    return std::nullopt;
+}
+
+void CompiledSchema::write(const ArgParser& parser, std::string& blob) {
+
+    if (!parser.m_subcommands.empty() || !parser.m_table->envBindings().empty() || !parser.m_config.empty()) {
+        throw ArgumentError("Subcommands, environment variables and config files cannot be written to a schema blob");
+    }
+
+    StringTable strings;
+    const auto programName = strings.intern(parser.m_programName);
+    const auto description = strings.intern(parser.m_description);
+    const auto version = strings.intern(parser.m_version);
+
+    std::string records;
+    std::array<std::uint32_t, shortNameCount> shortNames;
+    shortNames.fill(npos);
+
+    for (const auto& arg : parser.m_arguments) {
+
+        if (arg->hasValidator() || arg->isBound()) {
+            throw ArgumentError("Validators and bound arguments cannot be written to a schema blob: " +
+                                std::string(arg->name()));
+        }
+
+        std::string label;
+
+        if (arg->type() == ArgumentType::Positional) {
+            label = arg->name();
+
+        } else if (!arg->longName().empty()) {
+            label = "--" + std::string(arg->longName());
+
+        } else {
+            label = "-" + std::string(arg->shortName());
+        }
+
+        writeRef(records, strings.intern(arg->shortName()));
+        writeRef(records, strings.intern(arg->longName()));
+        writeRef(records, strings.intern(arg->name()));
+        writeRef(records, strings.intern(arg->description()));
+        writeRef(records, strings.intern(arg->defaultValue()));
+        writeRef(records, strings.intern(label));
+
+        const auto flags = static_cast<std::uint8_t>((arg->isRequired() ? requiredFlag : 0) |
+                                                    (arg->isMultiValue() ? multiValueFlag : 0));
+        records.push_back(static_cast<char>(arg->type()));
+        records.push_back(static_cast<char>(flags));
+        records.append(2, '\0');
+        write32(records, static_cast<std::uint32_t>(arg->nargs()));
+
+        if (arg->type() != ArgumentType::Positional && arg->shortName().length() == 1) {
+            const auto code = static_cast<unsigned char>(arg->shortName()[0]);
+
+            if (code < shortNameCount) {
+                shortNames[code] = static_cast<std::uint32_t>(arg->index());
+            }
+        }
+    }
+
+    // Hash and displace: names are spread over buckets of about four, then the
+    // largest buckets are placed first, each trying seeds until all of its
+    // names land on free slots.
+    struct Key {
+        std::string_view name;
+        std::uint32_t index;
+        std::uint64_t hash;
+    };
+
+    std::vector<Key> keys;
+    for (StringPool::Id id = 0; id < parser.m_argumentsById.size(); ++id) {
+        const auto index = parser.m_argumentsById[id];
+
+        if (index != ArgumentTable::npos) {
+            const auto name = parser.m_strings->view(id);
+            keys.push_back(Key{name, index, hashName(name)});
+        }
+    }
+
+    const auto bucketCount = static_cast<std::uint32_t>(std::max<std::size_t>(1, (keys.size() + 3) / 4));
+    std::uint32_t slotCount = 1;
+
+    while (slotCount < keys.size() + keys.size() / 4 + 1) {
+        slotCount <<= 1;
+    }
+
+    std::vector<std::vector<std::uint32_t>> buckets(bucketCount);
+
+    for (std::uint32_t i = 0; i < keys.size(); ++i) {
+        buckets[mix(keys[i].hash, 0) % bucketCount].push_back(i);
+    }
+
+    std::vector<std::uint32_t> order(bucketCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&buckets](std::uint32_t lhs, std::uint32_t rhs) {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    std::vector<std::uint32_t> displacements(bucketCount, 0);
+    std::vector<std::uint32_t> slots(slotCount, npos);
+    std::vector<std::uint32_t> candidate;
+
+    for (const auto bucket : order) {
+        const auto& members = buckets[bucket];
+
+        if (members.empty()) {
+            break;
+        }
+
+        for (std::uint32_t seed = 1;; ++seed) {
+
+            if (seed == npos) {
+                throw ArgumentError("Cannot build the schema blob hash table");
+            }
+
+            candidate.clear();
+
+            for (const auto member : members) {
+                const auto slot = static_cast<std::uint32_t>(mix(keys[member].hash, seed) & (slotCount - 1));
+
+                if (slots[slot] != npos || std::find(candidate.begin(), candidate.end(), slot) != candidate.end()) {
+                    break;
+                }
+                candidate.push_back(slot);
+            }
+
+            if (candidate.size() == members.size()) {
+
+                for (std::size_t i = 0; i < members.size(); ++i) {
+                    slots[candidate[i]] = members[i];
+                }
+                displacements[bucket] = seed;
+
+                break;
+            }
+        }
+    }
+
+    std::string slotBytes;
+
+    for (const auto key : slots) {
+
+        if (key == npos) {
+            writeRef(slotBytes, {});
+            write32(slotBytes, npos);
+
+        } else {
+            writeRef(slotBytes, strings.intern(keys[key].name));
+            write32(slotBytes, keys[key].index);
+        }
+    }
+
+    const auto positionals = parser.m_table->positionals();
+    const auto required = parser.m_table->required();
+
+    blob.clear();
+    blob.append(magic);
+    write32(blob, formatVersion);
+    write32(blob, byteOrderMark);
+    write32(blob, static_cast<std::uint32_t>(parser.m_arguments.size()));
+    write32(blob, bucketCount);
+    write32(blob, slotCount);
+    write32(blob, static_cast<std::uint32_t>(positionals.size()));
+    write32(blob, static_cast<std::uint32_t>(required.size()));
+    write32(blob, static_cast<std::uint32_t>(strings.bytes().size()));
+    writeRef(blob, programName);
+    writeRef(blob, description);
+    writeRef(blob, version);
+    blob.append(records);
+
+    for (const auto index : shortNames) {
+        write32(blob, index);
+    }
+
+    for (const auto displacement : displacements) {
+        write32(blob, displacement);
+    }
+
+    blob.append(slotBytes);
+
+    for (const auto index : positionals) {
+        write32(blob, index);
+    }
+
+    for (const auto index : required) {
+        write32(blob, index);
+    }
+
+    blob.append(strings.bytes());
+}
+
+std::string formatSchemaSource(std::string_view blob, std::string_view name) {
+    constexpr std::size_t bytesPerLine = 32;
+    std::string out;
+    out.append("#pragma once\n\n#include <string_view>\n\n")
+        .append("// Schema blob written by argparser::formatSchemaSource(); regenerate instead of editing.\n")
+        .append("inline constexpr std::string_view ").append(name).append("{\n");
+
+    for (std::size_t line = 0; line < blob.size(); line += bytesPerLine) {
+        out.append("    \"");
+
+        for (const char c : blob.substr(line, bytesPerLine)) {
+            const auto byte = static_cast<unsigned char>(c);
+
+            if (byte >= 0x20 && byte < 0x7f && c != '"' && c != '\\' && c != '?') {
+                out.push_back(c);
+
+            } else {
+                // Always three octal digits, so a following digit is never taken in.
+                const char escape[] = {'\\', static_cast<char>('0' + (byte >> 6)),
+                                        static_cast<char>('0' + ((byte >> 3) & 7)), static_cast<char>('0' + (byte & 7))};
+                out.append(escape, sizeof(escape));
+            }
+        }
+
+        out.append("\"\n");
+    }
+
+    out.append("    , ").append(std::to_string(blob.size())).append("};\n");
+
+    return out;
+}
+
+void CompiledResult::clear() noexcept {
+
+    for (const auto index : m_touched) {
+        m_values[index] = {};
+        m_counts[index] = 0;
+    }
+
+    m_touched.clear();
+    m_multiValues.clear();
+    m_positionals.clear();
+}
+
+void CompiledResult::store(std::uint32_t index, std::string_view value) {
+
+    if (m_counts[index] == 0) {
+        m_touched.push_back(index);
+    }
+
+    ++m_counts[index];
+    m_values[index] = value;
+
+    if (m_schema->isMultiValue(index)) {
+        m_multiValues.push_back(MultiValue{index, value});
+    }
+}
+
+std::uint32_t CompiledResult::indexOf(std::string_view name) const noexcept {
+    return m_schema ? m_schema->find(name) : CompiledSchema::npos;
+}
+
+std::string CompiledResult::getString(std::string_view name) const {
+    auto value = get<std::string>(name);
+
+    return value ? *value : "";
+}
+
+bool CompiledResult::isSet(std::string_view name) const {
+    return count(name) != 0;
+}
+
+std::size_t CompiledResult::count(std::string_view name) const {
+    const auto index = indexOf(name);
+
+    return index != CompiledSchema::npos ? m_counts[index] : 0;
+}
+
+}
@@ -0,0 +1,92 @@
+#include "ConfigReader.hpp"
+
+namespace argparser {
+
+namespace {
+
+[[nodiscard]] bool isBlank(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+[[nodiscard]] std::string_view trim(std::string_view text) noexcept {
+
+    while (!text.empty() && isBlank(text.front())) {
+        text.remove_prefix(1);
+    }
+
+    while (!text.empty() && isBlank(text.back())) {
+        text.remove_suffix(1);
+    }
+
+    return text;
+}
+
+// Drops the quotes around a quoted value, or a trailing comment from a bare one.
+[[nodiscard]] bool unquote(std::string_view& value) noexcept {
+
+    if (!value.empty() && (value.front() == '"' || value.front() == '\'')) {
+        const auto close = value.find(value.front(), 1);
+
+        if (close == std::string_view::npos) {
+            return false;
+        }
+
+        const auto rest = trim(value.substr(close + 1));
+        value = value.substr(1, close - 1);
+
+        return rest.empty() || rest.front() == '#' || rest.front() == ';';
+    }
+
+    for (std::size_t i = 1; i < value.length(); ++i) {
+
+        if (value[i] == '#' && isBlank(value[i - 1])) {
+            value = trim(value.substr(0, i));
+            break;
+        }
+    }
+
+    return true;
+}
+
+}
+
+bool ConfigReader::next(ConfigEntry& entry) noexcept {
+
+    while (m_position < m_contents.length() && m_errorLine == 0) {
+        auto end = m_contents.find('\n', m_position);
+
+        if (end == std::string_view::npos) {
+            end = m_contents.length();
+        }
+
+        const auto line = trim(m_contents.substr(m_position, end - m_position));
+        m_position = end + 1;
+        ++m_line;
+
+        if (line.empty() || line.front() == '#' || line.front() == ';') {
+            continue;
+        }
+
+        const auto eqPos = line.find('=');
+
+        if (eqPos == std::string_view::npos || line.front() == '[') {
+            m_errorLine = m_line;
+            break;
+        }
+
+        entry.key = trim(line.substr(0, eqPos));
+        entry.value = trim(line.substr(eqPos + 1));
+        entry.line = m_line;
+
+        if (entry.key.empty() || !unquote(entry.value)) {
+            m_errorLine = m_line;
+            break;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+}
@@ -0,0 +1,112 @@
+#include "MappedFile.hpp"
+
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ARGPARSER_HAS_MMAP 1
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace argparser {
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)),
+    m_size(std::exchange(other.m_size, 0)),
+    m_mapped(std::exchange(other.m_mapped, false)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+
+    if (this != &other) {
+        release();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_mapped = std::exchange(other.m_mapped, false);
+    }
+
+    return *this;
+}
+
+void MappedFile::release() noexcept {
+
+    if (!m_data) {
+        return;
+    }
+
+#ifdef ARGPARSER_HAS_MMAP
+    if (m_mapped) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+#else
+    delete[] m_data;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
+
+std::optional<MappedFile> MappedFile::open(const std::string& path) {
+    MappedFile file;
+
+#ifdef ARGPARSER_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    struct stat info {};
+
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+
+        return std::nullopt;
+    }
+
+    if (info.st_size > 0) {
+        const auto size = static_cast<std::size_t>(info.st_size);
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED) {
+            ::close(fd);
+
+            return std::nullopt;
+        }
+        ::madvise(data, size, MADV_SEQUENTIAL);
+
+        file.m_data = static_cast<const char*>(data);
+        file.m_size = size;
+        file.m_mapped = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+
+    if (!in) {
+        return std::nullopt;
+    }
+
+    const std::string buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    if (!buffer.empty()) {
+        auto* data = new char[buffer.size()];
+        buffer.copy(data, buffer.size());
+
+        file.m_data = data;
+        file.m_size = buffer.size();
+    }
+#endif
+
+    return file;
+}
+
+}
@@ -0,0 +1,17 @@
+#include "OutputSink.hpp"
+
+#include <iostream>
+
+namespace argparser {
+
+void StreamSink::write(std::string_view text) {
+    m_stream.write(text.data(), static_cast<std::streamsize>(text.length()));
+}
+
+OutputSink& standardOutput() {
+    static StreamSink sink(std::cout);
+
+    return sink;
+}
+
+}
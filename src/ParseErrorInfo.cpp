@@ -0,0 +1,93 @@
+#include "ParseErrorInfo.hpp"
+#include "Argument.hpp"
+#include "ArgumentTable.hpp"
+#include "Exceptions.hpp"
+#include "Tokenizer.hpp"
+
+namespace argparser {
+
+namespace {
+
+std::string argumentName(const Argument* argument) {
+
+    if (!argument) {
+        return "";
+    }
+
+    if (argument->type() == ArgumentType::Positional) {
+        return std::string(argument->name());
+    }
+
+    return !argument->longName().empty() ?
+        "--" + std::string(argument->longName()) : "-" + std::string(argument->shortName());
+}
+
+// " (did you mean --name?)" for unknown options, the candidates for ambiguous ones.
+std::string hint(const ParseErrorInfo& error) {
+
+    if (!error.schema) {
+        return "";
+    }
+
+    const auto key = splitToken(error.token).key;
+
+    if (error.code == ParseErrorCode::AmbiguousArgument) {
+        std::string candidates;
+
+        error.schema->visitPrefix(key, [&candidates](const ArgumentTable::NameEntry& entry) {
+            candidates.append(candidates.empty() ? " (could be --" : ", --").append(entry.name);
+        });
+
+        return candidates.empty() ? candidates : candidates + ")";
+    }
+
+    const auto suggestion = error.schema->suggest(key);
+
+    return suggestion.empty() ? "" : " (did you mean --" + std::string(suggestion) + "?)";
+}
+
+}
+
+std::string ParseErrorInfo::message() const {
+
+    switch (code) {
+    case ParseErrorCode::UnknownArgument:
+        return "Unknown argument: " + std::string(token) + hint(*this);
+    case ParseErrorCode::MissingValue:
+        return "Missing value for option: " + std::string(token);
+    case ParseErrorCode::UnexpectedValue:
+        return "Flag argument cannot have a value: " + std::string(token);
+    case ParseErrorCode::InvalidValue:
+        return "Invalid value for argument:" + std::string(value);
+    case ParseErrorCode::MissingRequired:
+        return "Missing required argument: " + (argument ? argumentName(argument) : std::string(token));
+    case ParseErrorCode::InvalidResponseFile:
+        return "Cannot expand response file: " + std::string(token.substr(1));
+    case ParseErrorCode::AmbiguousArgument:
+        return "Ambiguous argument: " + std::string(token) + hint(*this);
+    }
+
+    return "Unknown parse error";
+}
+
+void ParseErrorInfo::raise() const {
+
+    switch (code) {
+    case ParseErrorCode::UnknownArgument:
+        throw UnknownArgumentError(std::string(token) + hint(*this));
+    case ParseErrorCode::AmbiguousArgument:
+        throw AmbiguousArgumentError(std::string(token) + hint(*this));
+    case ParseErrorCode::MissingValue:
+    case ParseErrorCode::UnexpectedValue:
+    case ParseErrorCode::InvalidResponseFile:
+        throw ParseError(message());
+    case ParseErrorCode::InvalidValue:
+        throw ValidationError(message());
+    case ParseErrorCode::MissingRequired:
+        throw MissingArgumentError(argument ? argumentName(argument) : std::string(token));
+    }
+
+    throw ParseError(message());
+}
+
+}
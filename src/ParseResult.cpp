@@ -0,0 +1,126 @@
+#include "ParseResult.hpp"
+#include "ArgParser.hpp"
+
+#include <algorithm>
+
+namespace argparser {
+
+void ParseResult::NestedDeleter::operator()(ParseResult* result) const {
+    std::pmr::polymorphic_allocator<>(resource).delete_object(result);
+}
+
+void ParseResult::clear() noexcept {
+
+    for (const auto index : m_touched) {
+        m_values[index].clear();
+    }
+
+    m_touched.clear();
+    std::fill(m_setBits.begin(), m_setBits.end(), 0);
+    std::fill(m_resolvedBits.begin(), m_resolvedBits.end(), 0);
+    m_positionals.clear();
+    m_mappedFiles.clear();
+    m_programName = {};
+    m_subcommand = {};
+    m_state = ParseState::Complete;
+
+    if (m_subcommandResult) {
+        m_subcommandResult->clear();
+    }
+}
+
+const Argument* ParseResult::find(std::string_view name, const ArgumentValue*& value) const {
+
+    if (!m_schema) {
+        return nullptr;
+    }
+
+    const auto* arg = m_schema->findArgument(name);
+
+    if (!arg || arg->index() >= m_values.size()) {
+        return nullptr;
+    }
+
+    if (m_lazy) {
+        const auto bit = std::uint64_t{1} << (arg->index() % 64);
+        auto& resolved = m_resolvedBits[arg->index() / 64];
+
+        if (!(resolved & bit)) {
+            m_schema->resolveLazy(*this, *arg);
+            resolved |= bit;
+        }
+    }
+    value = &m_values[arg->index()];
+
+    return arg;
+}
+
+ArgumentValue& ParseResult::slot(std::size_t index) const {
+    auto& value = m_values[index];
+
+    if (!value.isSet()) {
+        m_touched.push_back(static_cast<std::uint32_t>(index));
+        m_setBits[index / 64] |= std::uint64_t{1} << (index % 64);
+    }
+
+    return value;
+}
+
+std::string ParseResult::getString(std::string_view name) const {
+    auto result = get<std::string>(name);
+
+    return result ? *result : "";
+}
+
+int ParseResult::getInt(std::string_view name) const {
+    const ArgumentValue* value = nullptr;
+    const auto* arg = find(name, value);
+
+    if (!arg) {
+        throw ArgumentError("Argument not found: " + std::string(name));
+    }
+
+    auto result = value->get<int>(arg->type(), arg->defaultValue());
+
+    if (!result) {
+        throw ValidationError ("Cannot convert value to int");
+    }
+
+    return *result;
+}
+
+double ParseResult::getDouble(std::string_view name) const {
+    const ArgumentValue* value = nullptr;
+    const auto* arg = find(name, value);
+
+    if (!arg) {
+        throw ArgumentError("Argument not found: " + std::string(name));
+    }
+
+    auto result = value->get<double>(arg->type(), arg->defaultValue());
+
+    if (!result) {
+        throw ValidationError ("Cannot convert value to double");
+    }
+
+    return *result;
+}
+
+bool ParseResult::getBool(std::string_view name) const {
+
+    return isSet(name);
+}
+
+std::size_t ParseResult::count(std::string_view name) const {
+    const ArgumentValue* value = nullptr;
+
+    return find(name, value) ? value->count() : 0;
+}
+
+bool ParseResult::isSet(std::string_view name) const {
+    const ArgumentValue* value = nullptr;
+
+    return find(name, value) ? value->isSet() : false;
+}
+
+}
@@ -0,0 +1,121 @@
+#include "StringPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace argparser {
+
+StringPool::StringPool(const allocator_type& alloc)
+    : m_arena(alloc.resource()), m_strings(alloc), m_hashes(alloc), m_slots(alloc) {
+    m_strings.emplace_back();
+    m_hashes.push_back(hash({}));
+}
+
+std::uint32_t StringPool::hash(std::string_view value) noexcept {
+    const auto full = std::hash<std::string_view>{}(value);
+
+    return static_cast<std::uint32_t>(full ^ (full >> 32));
+}
+
+std::size_t StringPool::slotOf(std::string_view value, std::uint32_t hashed) const noexcept {
+    const auto mask = m_slots.size() - 1;
+
+    for (auto slot = hashed & mask;; slot = (slot + 1) & mask) {
+        const auto id = m_slots[slot];
+
+        if (id == npos || (m_hashes[id] == hashed && m_strings[id] == value)) {
+            return slot;
+        }
+    }
+}
+
+StringPool::Id StringPool::find(std::string_view value) const noexcept {
+
+    if (value.empty()) {
+        return empty;
+    }
+
+    if (m_slots.empty()) {
+        return npos;
+    }
+
+    return m_slots[slotOf(value, hash(value))];
+}
+
+StringPool::Id StringPool::intern(std::string_view value) {
+
+    if (value.empty()) {
+        return empty;
+    }
+
+    if (2 * m_strings.size() >= m_slots.size()) {
+        rehash(std::max<std::size_t>(16, 2 * m_slots.size()));
+    }
+
+    const auto hashed = hash(value);
+    const auto slot = slotOf(value, hashed);
+
+    if (m_slots[slot] != npos) {
+        return m_slots[slot];
+    }
+
+    char* characters = allocate(value.length());
+    std::memcpy(characters, value.data(), value.length());
+
+    const auto id = static_cast<Id>(m_strings.size());
+    m_strings.emplace_back(characters, value.length());
+    m_hashes.push_back(hashed);
+    m_slots[slot] = id;
+    m_bytes += value.length();
+
+    return id;
+}
+
+void StringPool::reserve(std::size_t strings, std::size_t bytes) {
+    m_strings.reserve(m_strings.size() + strings);
+    m_hashes.reserve(m_hashes.size() + strings);
+
+    std::size_t slots = std::max<std::size_t>(16, m_slots.size());
+
+    while (slots <= 2 * (m_strings.size() + strings)) {
+        slots *= 2;
+    }
+
+    if (slots != m_slots.size()) {
+        rehash(slots);
+    }
+
+    if (bytes > m_reservedBytes) {
+        m_reserved = static_cast<char*>(m_arena.allocate(bytes, 1));
+        m_reservedBytes = bytes;
+    }
+}
+
+void StringPool::rehash(std::size_t slots) {
+    m_slots.assign(slots, npos);
+
+    for (Id id = 1; id < m_strings.size(); ++id) {
+        auto slot = m_hashes[id] & (slots - 1);
+
+        while (m_slots[slot] != npos) {
+            slot = (slot + 1) & (slots - 1);
+        }
+        m_slots[slot] = id;
+    }
+}
+
+char* StringPool::allocate(std::size_t length) {
+
+    if (length <= m_reservedBytes) {
+        char* characters = m_reserved;
+        m_reserved += length;
+        m_reservedBytes -= length;
+
+        return characters;
+    }
+
+    return static_cast<char*>(m_arena.allocate(length, 1));
+}
+
+}
@@ -0,0 +1,101 @@
+#include "Tokenizer.hpp"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARGPARSER_TOKENIZER_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define ARGPARSER_TOKENIZER_NEON 1
+#endif
+
+namespace argparser {
+
+namespace {
+
+// Option names rarely exceed this; longer tails go to memchr, which the C
+// library already dispatches to its widest vector unit at run time.
+constexpr std::size_t inlineScanLimit = 64;
+
+}
+
+std::size_t findEquals(std::string_view text) noexcept {
+    const char* data = text.data();
+    const std::size_t size = text.size();
+    const std::size_t inlineEnd = size < inlineScanLimit ? size : inlineScanLimit;
+    std::size_t i = 0;
+
+#if defined(ARGPARSER_TOKENIZER_SSE2)
+    const __m128i needle = _mm_set1_epi8('=');
+
+    for (; i + 16 <= inlineEnd; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+#elif defined(ARGPARSER_TOKENIZER_NEON)
+    const uint8x16_t needle = vdupq_n_u8('=');
+
+    for (; i + 16 <= inlineEnd; i += 16) {
+        const uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i));
+
+        // The match is somewhere in this block; the loop below pins it down.
+        if (vmaxvq_u8(vceqq_u8(block, needle)) != 0) {
+            break;
+        }
+    }
+#endif
+
+    if (size > inlineScanLimit && i == inlineScanLimit) {
+        const void* match = std::memchr(data + i, '=', size - i);
+
+        return match ? static_cast<std::size_t>(static_cast<const char*>(match) - data) : std::string_view::npos;
+    }
+
+    for (; i < size; ++i) {
+
+        if (data[i] == '=') {
+            return i;
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+Token splitToken(std::string_view arg) noexcept {
+    Token token;
+
+    if (arg.length() < 2 || arg.front() != '-') {
+        token.key = arg;
+
+        return token;
+    }
+
+    if (arg[1] != '-') {
+        token.kind = TokenKind::Short;
+        token.key = arg.substr(1);
+
+        return token;
+    }
+
+    token.kind = TokenKind::Long;
+    const auto body = arg.substr(2);
+    const auto eqPos = findEquals(body);
+
+    if (eqPos == std::string_view::npos) {
+        token.key = body;
+    } else {
+        token.key = body.substr(0, eqPos);
+        token.value = body.substr(eqPos + 1);
+        token.hasValue = true;
+    }
+
+    return token;
+}
+
+}
@@ -0,0 +1,132 @@
+#include "ValueChecks.hpp"
+#include "Converter.hpp"
+#include "Exceptions.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#if __has_include(<sys/stat.h>)
+#include <sys/stat.h>
+#define ARGPARSER_HAS_STAT 1
+#else
+#include <filesystem>
+#endif
+
+namespace argparser {
+
+namespace {
+
+bool fileExists(std::string_view path) {
+#if ARGPARSER_HAS_STAT
+    // stat() wants a terminated string; a stack copy keeps the check off the heap.
+    std::array<char, 4096> buffer;
+
+    if (path.empty() || path.size() >= buffer.size()) {
+        return false;
+    }
+
+    std::copy(path.begin(), path.end(), buffer.begin());
+    buffer[path.size()] = '\0';
+    struct stat info;
+
+    return ::stat(buffer.data(), &info) == 0;
+#else
+    std::error_code error;
+
+    return std::filesystem::exists(std::filesystem::path(path), error);
+#endif
+}
+
+}
+
+void ValueChecks::range(double min, double max) noexcept {
+    m_min = min;
+    m_max = max;
+    m_kinds |= Range;
+}
+
+void ValueChecks::length(std::size_t min, std::size_t max) noexcept {
+    m_minLength = min;
+    m_maxLength = max;
+    m_kinds |= Length;
+}
+
+void ValueChecks::choices(std::initializer_list<std::string_view> values) {
+    m_choices.clear();
+
+    for (const auto value : values) {
+        m_choices.emplace_back(value);
+    }
+    m_kinds |= Choices;
+}
+
+void ValueChecks::pattern(std::string_view regex) {
+    m_pattern = regex;
+    allocator_type alloc = m_pattern.get_allocator();
+    m_compiled = std::unique_ptr<CompiledPattern, PatternDeleter>(alloc.new_object<CompiledPattern>(),
+                                                                    PatternDeleter{alloc.resource()});
+    m_kinds |= Pattern;
+}
+
+void ValueChecks::pathExists(bool enabled) noexcept {
+
+    if (enabled) {
+        m_kinds |= PathExists;
+    } else {
+        m_kinds &= static_cast<std::uint8_t>(~PathExists);
+    }
+}
+
+void ValueChecks::compile() const {
+
+    if (!m_compiled) {
+        return;
+    }
+
+    std::call_once(m_compiled->once, [this] {
+
+        try {
+            m_compiled->regex.emplace(m_pattern.begin(), m_pattern.end(), std::regex::ECMAScript | std::regex::optimize);
+
+        } catch (const std::regex_error& error) {
+            throw ArgumentError("Invalid pattern '" + std::string(m_pattern) + "': " + error.what());
+        }
+    });
+}
+
+bool ValueChecks::accepts(std::string_view value) const {
+
+    if (m_kinds == 0) {
+        return true;
+    }
+
+    if ((m_kinds & Length) && (value.size() < m_minLength || value.size() > m_maxLength)) {
+        return false;
+    }
+
+    if (m_kinds & Range) {
+        double number = 0;
+
+        // NaN compares false both ways, so it is rejected explicitly along with infinities.
+        if (!convertValue(value, number) || !std::isfinite(number) || number < m_min || number > m_max) {
+            return false;
+        }
+    }
+
+    if ((m_kinds & Choices) && std::find(m_choices.begin(), m_choices.end(), value) == m_choices.end()) {
+        return false;
+    }
+
+    if (m_kinds & Pattern) {
+        compile();
+
+        if (!std::regex_match(value.begin(), value.end(), *m_compiled->regex)) {
+            return false;
+        }
+    }
+
+    return !(m_kinds & PathExists) || fileExists(value);
+}
+
+}
@@ -0,0 +1,93 @@
+#include "ArgParser.hpp"
+#include "TestSupport.hpp"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+using argparser::ArgParser;
+using argparser::CommandLine;
+using argparser::InlineExecutor;
+using argparser::RowState;
+using argparser::StringSink;
+using argparser::test::setEnv;
+
+namespace {
+
+void rowStates() {
+    std::string printed;
+    StringSink sink(printed);
+    ArgParser parser("tool");
+    parser.version("2.0").exitOnHelp(false).output(&sink);
+    parser.addOption("n", "name", "Name", "anon");
+    parser.addFlag("v", "verbose", "");
+
+    const std::array<std::string_view, 2> ok{"--name", "given"};
+    const std::array<std::string_view, 3> help{"--name", "given", "--help"};
+    const std::array<std::string_view, 2> version{"-v", "--version"};
+    const std::array<std::string_view, 1> error{"--bogus"};
+    const std::array<CommandLine, 4> lines{CommandLine{ok}, CommandLine{help}, CommandLine{version},
+                                            CommandLine{error}};
+
+    InlineExecutor executor;
+    const auto batch = parser.parseBatch(lines, executor);
+    const auto name = batch.column("name");
+    const auto verbose = batch.column("verbose");
+
+    CHECK(batch.state(0) == RowState::Ok);
+    CHECK(batch.state(1) == RowState::HelpRequested);
+    CHECK(batch.state(2) == RowState::VersionRequested);
+    CHECK(batch.state(3) == RowState::Error);
+
+    CHECK(!batch.failed(1) && !batch.failed(2) && batch.failed(3));
+    CHECK(batch.errors().size() == 1 && batch.errors().front().row == 3);
+
+    CHECK(batch.values(name)[0] == "given");
+    CHECK(batch.values(name)[1] == "anon");
+    CHECK(batch.counts(name)[1] == 0);
+    CHECK(batch.values(verbose)[2] == "false");
+    CHECK(printed.empty());
+}
+
+}
+
+// Rows take the parser's config values but never the process environment.
+void rowsUseTheConfig() {
+    const auto path = (std::filesystem::temp_directory_path() / "argparser_batch.ini").string();
+    std::ofstream(path, std::ios::binary) << "port = 8080\nverbose = on\n";
+
+    ArgParser parser("tool");
+    parser.addOption("p", "port", "Port", "80").env("ARGPARSER_TEST_BATCH_PORT");
+    parser.addFlag("v", "verbose", "").env("ARGPARSER_TEST_BATCH_VERBOSE");
+    parser.addOption("n", "name", "Name", "anon");
+    parser.loadConfig(path);
+    setEnv("ARGPARSER_TEST_BATCH_PORT", "9000");
+    setEnv("ARGPARSER_TEST_BATCH_VERBOSE", "off");
+
+    const std::array<std::string_view, 0> none{};
+    const std::array<std::string_view, 2> given{"--port", "1"};
+    const std::array<CommandLine, 2> lines{CommandLine{none}, CommandLine{given}};
+
+    InlineExecutor executor;
+    const auto batch = parser.parseBatch(lines, executor);
+    const auto port = batch.column("port");
+    const auto verbose = batch.column("verbose");
+
+    CHECK(batch.state(0) == RowState::Ok && batch.state(1) == RowState::Ok);
+    CHECK(batch.values(port)[0] == "8080");
+    CHECK(batch.values(port)[1] == "1");
+    CHECK(batch.values(verbose)[0] == "true" && batch.values(verbose)[1] == "true");
+    CHECK(batch.values(batch.column("name"))[0] == "anon");
+
+    setEnv("ARGPARSER_TEST_BATCH_PORT", nullptr);
+    setEnv("ARGPARSER_TEST_BATCH_VERBOSE", nullptr);
+}
+
+int main() {
+    rowStates();
+    rowsUseTheConfig();
+
+    return argparser::test::finish();
+}
@@ -0,0 +1,114 @@
+#include "ArgParser.hpp"
+#include "TestSupport.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using argparser::ArgParser;
+using argparser::ArgumentError;
+using argparser::ParseResult;
+using argparser::test::Argv;
+using argparser::test::setEnv;
+
+namespace {
+
+std::string writeConfig(const std::string& name, const std::string& contents) {
+    const auto path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream(path, std::ios::binary) << contents;
+
+    return path;
+}
+
+void buildSchema(ArgParser& parser) {
+    parser.addOption("p", "port", "Port", "80").env("ARGPARSER_TEST_CONFIG_PORT");
+    parser.addOption("I", "include", "Include").append();
+    parser.addFlag("v", "verbose", "Verbose").env("ARGPARSER_TEST_CONFIG_VERBOSE");
+}
+
+void precedence() {
+    ArgParser parser("tool");
+    buildSchema(parser);
+    parser.loadConfig(writeConfig("argparser_precedence.ini", "port = 8080\ninclude = a\ninclude = b\n"));
+    ParseResult result;
+
+    Argv none{"tool"};
+    parser.parseOptions(none.argc(), none.argv(), result);
+    CHECK(result.getInt("port") == 8080);
+    CHECK(result.getAll<std::string>("include") == (std::vector<std::string>{"a", "b"}));
+
+    setEnv("ARGPARSER_TEST_CONFIG_PORT", "9000");
+    parser.parseOptions(none.argc(), none.argv(), result);
+    CHECK(result.getInt("port") == 9000);
+
+    Argv given{"tool", "--port", "1"};
+    parser.parseOptions(given.argc(), given.argv(), result);
+    CHECK(result.getInt("port") == 1);
+    setEnv("ARGPARSER_TEST_CONFIG_PORT", nullptr);
+}
+
+void falseInTheEnvironmentOutranksTheFile() {
+    const auto path = writeConfig("argparser_flag.ini", "verbose = yes\n");
+    Argv none{"tool"};
+
+    for (const bool lazy : {false, true}) {
+        ArgParser parser("tool");
+        buildSchema(parser);
+        parser.lazy(lazy);
+        parser.loadConfig(path);
+        ParseResult result;
+
+        parser.parseOptions(none.argc(), none.argv(), result);
+        CHECK(result.isSet("verbose"));
+
+        setEnv("ARGPARSER_TEST_CONFIG_VERBOSE", "no");
+        parser.parseOptions(none.argc(), none.argv(), result);
+        CHECK(!result.isSet("verbose"));
+        setEnv("ARGPARSER_TEST_CONFIG_VERBOSE", nullptr);
+    }
+}
+
+bool shows(const ArgParser& parser, const std::string& text) {
+    return parser.help().find(text) != std::string::npos;
+}
+
+void helpShowsTheMergedValues() {
+    ArgParser parser("tool");
+    buildSchema(parser);
+    CHECK(shows(parser, "Port (default: 80) (env: ARGPARSER_TEST_CONFIG_PORT)\n"));
+
+    parser.loadConfig(writeConfig("argparser_help.ini", "port = 8080\ninclude = a\ninclude = b\nverbose = on\n"));
+    CHECK(shows(parser, "Port (default: 80, config: 8080) (env: ARGPARSER_TEST_CONFIG_PORT)\n"));
+    CHECK(shows(parser, "Include (config: a, b)\n"));
+    CHECK(shows(parser, "Verbose (config: on) (env: ARGPARSER_TEST_CONFIG_VERBOSE)\n"));
+
+    // The cached text follows the environment, which outranks the file.
+    setEnv("ARGPARSER_TEST_CONFIG_PORT", "9000");
+    setEnv("ARGPARSER_TEST_CONFIG_VERBOSE", "off");
+    CHECK(shows(parser, "Port (default: 80) (env: ARGPARSER_TEST_CONFIG_PORT=9000)\n"));
+    CHECK(shows(parser, "Verbose (env: ARGPARSER_TEST_CONFIG_VERBOSE=off)\n"));
+
+    setEnv("ARGPARSER_TEST_CONFIG_PORT", nullptr);
+    setEnv("ARGPARSER_TEST_CONFIG_VERBOSE", nullptr);
+    CHECK(shows(parser, "Port (default: 80, config: 8080) (env: ARGPARSER_TEST_CONFIG_PORT)\n"));
+    CHECK(shows(parser, "Verbose (config: on) (env: ARGPARSER_TEST_CONFIG_VERBOSE)\n"));
+}
+
+void invalidFlagValueThrows() {
+    ArgParser parser("tool");
+    buildSchema(parser);
+
+    CHECK_THROWS(parser.loadConfig(writeConfig("argparser_bad_flag.ini", "verbose = maybe\n")), ArgumentError);
+    CHECK_THROWS(parser.loadConfig(writeConfig("argparser_unknown.ini", "bogus = 1\n")), ArgumentError);
+}
+
+}
+
+int main() {
+    precedence();
+    falseInTheEnvironmentOutranksTheFile();
+    helpShowsTheMergedValues();
+    invalidFlagValueThrows();
+
+    return argparser::test::finish();
+}
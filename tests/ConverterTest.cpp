@@ -0,0 +1,121 @@
+#include "ArgParser.hpp"
+#include "Converter.hpp"
+#include "StaticSchema.hpp"
+#include "TestSupport.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+using argparser::ArgParser;
+using argparser::ByteSize;
+using argparser::ParseResult;
+using argparser::convertValue;
+using argparser::test::Argv;
+
+namespace {
+
+void scaledValuesAtTheLimits() {
+    std::chrono::nanoseconds ns{};
+
+    CHECK(convertValue("9223372036.854775807s", ns) && ns.count() == std::numeric_limits<std::int64_t>::max());
+    CHECK(!convertValue("9223372036.854775808s", ns));
+    CHECK(!convertValue("-9223372037.5s", ns));
+    CHECK(convertValue("9223372036854775807ns", ns) && ns.count() == std::numeric_limits<std::int64_t>::max());
+    CHECK(convertValue("-9223372036.854775808s", ns) && ns.count() == std::numeric_limits<std::int64_t>::min());
+    CHECK(!convertValue("9223372037s", ns));
+    CHECK(convertValue("1.5s", ns) && ns.count() == 1'500'000'000);
+
+    ByteSize size;
+    CHECK(!convertValue("16777216.0TiB", size));
+    CHECK(!convertValue("18446744073.709551616GB", size));
+    CHECK(!convertValue("-1.5KiB", size));
+    CHECK(convertValue("1.5KiB", size) && size.bytes == 1536);
+}
+
+void scaledValuesMustBeWhole() {
+    std::chrono::nanoseconds ns{};
+
+    CHECK(!convertValue("1.5ns", ns));
+    CHECK(!convertValue("1.0000000001s", ns));
+    CHECK(!convertValue("0.5000000003s", ns));
+    CHECK(!convertValue("-0.0000000001s", ns));
+    CHECK(convertValue("0.000000001s", ns) && ns.count() == 1);
+    CHECK(convertValue("1.250000000000000000000s", ns) && ns.count() == 1'250'000'000);
+    CHECK(convertValue("-2.5ms", ns) && ns.count() == -2'500'000);
+    CHECK(!convertValue(".5s", ns));
+    CHECK(!convertValue("1.5.s", ns));
+
+    ByteSize size;
+    CHECK(!convertValue("1.0000000001GiB", size));
+    CHECK(!convertValue("1.0001KiB", size));
+    CHECK(convertValue("0.0009765625KiB", size) && size.bytes == 1);
+    CHECK(convertValue("1.25GB", size) && size.bytes == 1'250'000'000);
+}
+
+void failedConversionKeepsTheValue() {
+    int port = 80;
+    CHECK(!convertValue("12abc", port) && port == 80);
+    CHECK(!convertValue("99999999999", port) && port == 80);
+
+    double ratio = 0.5;
+    CHECK(!convertValue("1.5x", ratio) && ratio == 0.5);
+
+    std::chrono::milliseconds timeout{7};
+    CHECK(!convertValue("1.5ns", timeout) && timeout.count() == 7);
+
+    ByteSize size{42};
+    CHECK(!convertValue("1.0001KiB", size) && size.bytes == 42);
+
+    ArgParser parser("tool");
+    parser.exitOnHelp(false);
+    int bound = 8080;
+    parser.addOption("p", "port", "").bind(bound);
+    Argv line{"tool", "--port", "80x"};
+    ParseResult result;
+    CHECK(parser.tryParse(line.argc(), line.argv(), result).has_value());
+    CHECK(bound == 8080);
+
+    using Port = argparser::Opt<"port", int, 'p'>;
+    argparser::StaticSchema<Port> schema;
+    schema.defaultValue<Port>(8080);
+    Argv partial{"tool", "-p", "80x"};
+    CHECK_THROWS(schema.parseOptions(partial.argc(), partial.argv()), argparser::ValidationError);
+    CHECK(schema.get<Port>() == 8080);
+}
+
+void boolWordsOnly() {
+    bool value = false;
+
+    CHECK(convertValue("YES", value) && value);
+    CHECK(convertValue("off", value) && !value);
+    CHECK(!convertValue("maybe", value));
+    CHECK(!convertValue("", value));
+    CHECK(!convertValue("2", value));
+}
+
+void getBoolOnAnOption() {
+    ArgParser parser("tool");
+    parser.addOption("", "enabled", "");
+    ParseResult result;
+
+    Argv word{"tool", "--enabled", "maybe"};
+    parser.parseOptions(word.argc(), word.argv(), result);
+    CHECK(!result.get<bool>("enabled"));
+
+    Argv yes{"tool", "--enabled", "on"};
+    parser.parseOptions(yes.argc(), yes.argv(), result);
+    CHECK(result.get<bool>("enabled") == true);
+}
+
+}
+
+int main() {
+    scaledValuesAtTheLimits();
+    scaledValuesMustBeWhole();
+    failedConversionKeepsTheValue();
+    boolWordsOnly();
+    getBoolOnAnOption();
+
+    return argparser::test::finish();
+}
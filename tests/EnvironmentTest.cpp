@@ -0,0 +1,109 @@
+#include "ArgParser.hpp"
+#include "TestSupport.hpp"
+
+using argparser::ArgParser;
+using argparser::ArgumentError;
+using argparser::ParseErrorCode;
+using argparser::ParseResult;
+using argparser::test::Argv;
+using argparser::test::setEnv;
+
+namespace {
+
+void duplicateBindingThrows() {
+    ArgParser parser("tool");
+    auto& first = parser.addOption("", "aa", "first");
+    auto& second = parser.addOption("", "bb", "second");
+    first.env("ARGPARSER_TEST_SHARED");
+
+    CHECK_THROWS(second.env("ARGPARSER_TEST_SHARED"), ArgumentError);
+    CHECK(second.envName().empty());
+
+    setEnv("ARGPARSER_TEST_SHARED", "5");
+    Argv argv{"tool"};
+    ParseResult result;
+    parser.parseOptions(argv.argc(), argv.argv(), result);
+
+    CHECK(result.getString("aa") == "5");
+    CHECK(!result.isSet("bb"));
+    setEnv("ARGPARSER_TEST_SHARED", nullptr);
+}
+
+void rebindingReleasesTheOldName() {
+    ArgParser parser("tool");
+    auto& first = parser.addOption("", "aa", "first");
+    auto& second = parser.addOption("", "bb", "second");
+    first.env("ARGPARSER_TEST_OLD");
+    first.env("ARGPARSER_TEST_OLD");
+    first.env("ARGPARSER_TEST_NEW");
+    second.env("ARGPARSER_TEST_OLD");
+
+    CHECK(first.envName() == "ARGPARSER_TEST_NEW");
+    CHECK(second.envName() == "ARGPARSER_TEST_OLD");
+}
+
+void commandLineWinsOverEnvironment() {
+    ArgParser parser("tool");
+    parser.addOption("p", "port", "Port", "80").env("ARGPARSER_TEST_PORT");
+    ParseResult result;
+
+    Argv unset{"tool"};
+    parser.parseOptions(unset.argc(), unset.argv(), result);
+    CHECK(result.getInt("port") == 80);
+
+    setEnv("ARGPARSER_TEST_PORT", "8080");
+    parser.parseOptions(unset.argc(), unset.argv(), result);
+    CHECK(result.getInt("port") == 8080);
+
+    Argv given{"tool", "--port", "9090"};
+    parser.parseOptions(given.argc(), given.argv(), result);
+    CHECK(result.getInt("port") == 9090);
+    setEnv("ARGPARSER_TEST_PORT", nullptr);
+}
+
+void rejectedValueFailsTheParse() {
+    ArgParser parser("tool");
+    parser.addOption("p", "port", "Port").range(1, 65535).env("ARGPARSER_TEST_PORT");
+    setEnv("ARGPARSER_TEST_PORT", "0");
+
+    Argv argv{"tool"};
+    ParseResult result;
+    const auto error = parser.tryParse(argv.argc(), argv.argv(), result);
+
+    CHECK(error && error->code == ParseErrorCode::InvalidValue);
+    CHECK(error && error->value == "0");
+    setEnv("ARGPARSER_TEST_PORT", nullptr);
+}
+
+void flagTakesBoolWordsOnly() {
+    ArgParser parser("tool");
+    parser.addFlag("v", "verbose", "").env("ARGPARSER_TEST_VERBOSE");
+    ParseResult result;
+    Argv argv{"tool"};
+
+    setEnv("ARGPARSER_TEST_VERBOSE", "Yes");
+    CHECK(!parser.tryParse(argv.argc(), argv.argv(), result));
+    CHECK(result.isSet("verbose"));
+
+    setEnv("ARGPARSER_TEST_VERBOSE", "off");
+    CHECK(!parser.tryParse(argv.argc(), argv.argv(), result));
+    CHECK(!result.isSet("verbose"));
+
+    setEnv("ARGPARSER_TEST_VERBOSE", "maybe");
+    const auto error = parser.tryParse(argv.argc(), argv.argv(), result);
+    CHECK(error && error->code == ParseErrorCode::InvalidValue);
+    CHECK(error && error->value == "maybe");
+    setEnv("ARGPARSER_TEST_VERBOSE", nullptr);
+}
+
+}
+
+int main() {
+    duplicateBindingThrows();
+    rebindingReleasesTheOldName();
+    commandLineWinsOverEnvironment();
+    rejectedValueFailsTheParse();
+    flagTakesBoolWordsOnly();
+
+    return argparser::test::finish();
+}
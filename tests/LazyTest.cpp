@@ -0,0 +1,102 @@
+#include "ArgParser.hpp"
+#include "TestSupport.hpp"
+
+using argparser::ArgParser;
+using argparser::ArgumentError;
+using argparser::ParseErrorCode;
+using argparser::ParseResult;
+using argparser::ValidationError;
+using argparser::test::Argv;
+using argparser::test::setEnv;
+
+namespace {
+
+ArgParser& buildSchema(ArgParser& parser) {
+    parser.addOption("p", "port", "Port", "80").range(1, 65535).env("ARGPARSER_TEST_LAZY_PORT");
+    parser.addOption("n", "name", "Name", "anon");
+    parser.addFlag("v", "verbose", "").env("ARGPARSER_TEST_LAZY_VERBOSE");
+    parser.addPositional("input", "Input", true);
+    parser.lazy();
+
+    return parser;
+}
+
+void rejectedValueThrowsOnFirstRead() {
+    ArgParser parser("tool");
+    buildSchema(parser);
+    ParseResult result;
+
+    Argv argv{"tool", "--port", "0", "--name", "x", "in"};
+    CHECK(!parser.tryParse(argv.argc(), argv.argv(), result));
+
+    CHECK(result.getString("name") == "x");
+    CHECK_THROWS(result.get<int>("port"), ValidationError);
+    // The argument stays unchecked, so every read reports it.
+    CHECK_THROWS(result.isSet("port"), ValidationError);
+    CHECK(result.positionalViews().size() == 1);
+}
+
+void structuralErrorsStillFailTheParse() {
+    ArgParser parser("tool");
+    buildSchema(parser);
+    ParseResult result;
+
+    Argv unknown{"tool", "--bogus", "in"};
+    auto error = parser.tryParse(unknown.argc(), unknown.argv(), result);
+    CHECK(error && error->code == ParseErrorCode::UnknownArgument);
+
+    Argv missingValue{"tool", "in", "--name"};
+    error = parser.tryParse(missingValue.argc(), missingValue.argv(), result);
+    CHECK(error && error->code == ParseErrorCode::MissingValue);
+
+    Argv missingRequired{"tool", "--name", "x"};
+    error = parser.tryParse(missingRequired.argc(), missingRequired.argv(), result);
+    CHECK(error && error->code == ParseErrorCode::MissingRequired);
+}
+
+void environmentIsReadOnFirstRead() {
+    ArgParser parser("tool");
+    buildSchema(parser);
+    ParseResult result;
+    Argv argv{"tool", "in"};
+
+    setEnv("ARGPARSER_TEST_LAZY_PORT", "8080");
+    CHECK(!parser.tryParse(argv.argc(), argv.argv(), result));
+    CHECK(result.getInt("port") == 8080);
+
+    setEnv("ARGPARSER_TEST_LAZY_PORT", "70000");
+    CHECK(!parser.tryParse(argv.argc(), argv.argv(), result));
+    CHECK_THROWS(result.getInt("port"), ValidationError);
+    setEnv("ARGPARSER_TEST_LAZY_PORT", nullptr);
+
+    setEnv("ARGPARSER_TEST_LAZY_VERBOSE", "maybe");
+    CHECK(!parser.tryParse(argv.argc(), argv.argv(), result));
+    CHECK_THROWS(result.isSet("verbose"), ValidationError);
+    setEnv("ARGPARSER_TEST_LAZY_VERBOSE", nullptr);
+
+    CHECK(!parser.tryParse(argv.argc(), argv.argv(), result));
+    CHECK(result.getInt("port") == 80);
+    CHECK(!result.isSet("verbose"));
+}
+
+void boundArgumentsAreRejected() {
+    ArgParser parser("tool");
+    int port = 0;
+    parser.addOption("p", "port", "Port").bind(port);
+    parser.lazy();
+    ParseResult result;
+    Argv argv{"tool"};
+
+    CHECK_THROWS(parser.tryParse(argv.argc(), argv.argv(), result), ArgumentError);
+}
+
+}
+
+int main() {
+    rejectedValueThrowsOnFirstRead();
+    structuralErrorsStillFailTheParse();
+    environmentIsReadOnFirstRead();
+    boundArgumentsAreRejected();
+
+    return argparser::test::finish();
+}
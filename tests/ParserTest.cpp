@@ -0,0 +1,79 @@
+#include "ArgParser.hpp"
+#include "TestSupport.hpp"
+
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+using argparser::ArgParser;
+using argparser::test::Argv;
+
+static_assert(std::is_move_constructible_v<ArgParser>);
+static_assert(std::is_move_assignable_v<ArgParser>);
+
+namespace {
+
+void buildSchema(ArgParser& parser) {
+    parser.exitOnHelp(false);
+    parser.addOption("n", "name", "Name", "anon");
+    parser.addPositional("input", "Input file");
+}
+
+// The parsed values point into tokens the source parser owns; they have to
+// come along even when the two parsers allocate from different resources.
+void moveAssignAcrossResources() {
+    std::pmr::monotonic_buffer_resource arena;
+    ArgParser target("target");
+    std::optional<ArgParser> source(std::in_place, "source", "", &arena);
+    buildSchema(*source);
+    source->parsePositionalOption(std::vector<std::string>{"--name", "bob", "in"});
+
+    target = std::move(*source);
+    source.reset();
+
+    CHECK(target.get<std::string>("name") == "bob");
+    CHECK(target.get<std::string>("input") == "in");
+
+    Argv line{"source", "--name", "alice"};
+    CHECK(!target.tryParse(line.argc(), line.argv()));
+    CHECK(target.get<std::string>("name") == "alice");
+    CHECK(target.help().find("--name") != std::string::npos);
+}
+
+// A sink that reads the help again from inside write(), as a tee might.
+class ReentrantSink final : public argparser::OutputSink {
+public:
+    explicit ReentrantSink(const ArgParser& parser) : m_parser(parser) {}
+
+    void write(std::string_view text) override {
+        m_written.assign(text);
+        m_again = m_parser.help();
+    }
+
+    const ArgParser& m_parser;
+    std::string m_written;
+    std::string m_again;
+};
+
+void sinkMayReadTheHelp() {
+    ArgParser parser("tool");
+    buildSchema(parser);
+    ReentrantSink sink(parser);
+    parser.output(&sink);
+
+    parser.printHelp();
+    CHECK(sink.m_written == parser.help() + "\n");
+    CHECK(sink.m_again == parser.help());
+}
+
+}
+
+int main() {
+    moveAssignAcrossResources();
+    sinkMayReadTheHelp();
+
+    return argparser::test::finish();
+}
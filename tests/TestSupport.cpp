@@ -0,0 +1,20 @@
+#include "TestSupport.hpp"
+
+#include <cstdlib>
+
+namespace argparser::test {
+
+void setEnv(const char* name, const char* value) {
+#if defined(_WIN32)
+    _putenv_s(name, value ? value : "");
+#else
+
+    if (value) {
+        setenv(name, value, 1);
+    } else {
+        unsetenv(name);
+    }
+#endif
+}
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Just enough of a test harness for plain executables run by CTest: CHECK
+// records a failure and carries on, and finish() turns the count into the
+// exit status.
+namespace argparser::test {
+
+inline int& failures() {
+    static int count = 0;
+
+    return count;
+}
+
+inline void fail(const char* file, int line, const char* what) {
+    std::cerr << file << ":" << line << ": check failed: " << what << "\n";
+    ++failures();
+}
+
+[[nodiscard]] inline int finish() {
+
+    if (failures() != 0) {
+        std::cerr << failures() << " check(s) failed\n";
+    }
+
+    return failures() == 0 ? 0 : 1;
+}
+
+// Sets an environment variable for the rest of the process; nullptr removes it.
+void setEnv(const char* name, const char* value);
+
+// Owns a command line; the program name comes first.
+class Argv {
+public:
+    Argv(std::initializer_list<const char*> tokens)
+        : m_tokens(tokens.begin(), tokens.end()) {
+
+        for (auto& token : m_tokens) {
+            m_pointers.push_back(token.data());
+        }
+    }
+
+    [[nodiscard]] int argc() const noexcept { return static_cast<int>(m_pointers.size()); }
+    [[nodiscard]] char** argv() noexcept { return m_pointers.data(); }
+
+private:
+    std::vector<std::string> m_tokens;
+    std::vector<char*> m_pointers;
+};
+
+}
+
+#define CHECK(expression)                                                   \
+    ((expression) ? void() : argparser::test::fail(__FILE__, __LINE__, #expression))
+
+#define CHECK_THROWS(expression, Exception)                                 \
+    do {                                                                    \
+        bool thrown = false;                                                \
+                                                                            \
+        try {                                                               \
+            (void)(expression);                                             \
+        } catch (const Exception&) {                                        \
+            thrown = true;                                                  \
+        }                                                                   \
+                                                                            \
+        if (!thrown) {                                                      \
+            argparser::test::fail(__FILE__, __LINE__, #expression " throws " #Exception); \
+        }                                                                   \
+    } while (false)
@@ -0,0 +1,55 @@
+#include "ArgParser.hpp"
+#include "TestSupport.hpp"
+
+#include <limits>
+
+using argparser::ArgParser;
+using argparser::ParseErrorCode;
+using argparser::ParseResult;
+using argparser::test::Argv;
+
+namespace {
+
+bool parses(const ArgParser& parser, const char* value) {
+    Argv line{"tool", "--ratio", value};
+    ParseResult result;
+
+    return !parser.tryParse(line.argc(), line.argv(), result).has_value();
+}
+
+void rangeRejectsNonFinite() {
+    ArgParser parser("tool");
+    parser.addOption("", "ratio", "Ratio").range(0, 1);
+
+    CHECK(parses(parser, "0.5"));
+    CHECK(parses(parser, "1"));
+    CHECK(!parses(parser, "1.5"));
+    CHECK(!parses(parser, "nan"));
+    CHECK(!parses(parser, "-nan"));
+    CHECK(!parses(parser, "inf"));
+    CHECK(!parses(parser, "-inf"));
+
+    Argv line{"tool", "--ratio", "nan"};
+    ParseResult result;
+    const auto error = parser.tryParse(line.argc(), line.argv(), result);
+    CHECK(error && error->code == ParseErrorCode::InvalidValue);
+}
+
+void unboundedRangeStillRejectsNonFinite() {
+    constexpr auto infinity = std::numeric_limits<double>::infinity();
+    ArgParser parser("tool");
+    parser.addOption("", "ratio", "Ratio").range(-infinity, infinity);
+
+    CHECK(parses(parser, "1e300"));
+    CHECK(!parses(parser, "inf"));
+    CHECK(!parses(parser, "nan"));
+}
+
+}
+
+int main() {
+    rangeRejectsNonFinite();
+    unboundedRangeStillRejectsNonFinite();
+
+    return argparser::test::finish();
+}